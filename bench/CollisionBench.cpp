@@ -0,0 +1,279 @@
+// CollisionBench.cpp - Compare les kernels de chevauchement AABB au test
+// historique par forme (CheckCollisionRecs), puis mesure CollisionSystem
+// (génération, requêtes et balayages de la taille du joueur) sur une carte
+// générée
+#include <raylib.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/Map/CollisionKernels.h"
+#include "../src/Map/CollisionSystem.h"
+
+//==============================================================================
+// CONFIGURATION
+//==============================================================================
+static constexpr int BOX_COUNT = 16384;
+static constexpr int QUERY_COUNT = 2048;
+static constexpr int REPEATS = 5;
+
+// Grille : carte de tuiles 32x32 dont une partie porte une collision, et
+// hitbox du joueur balayée sur une frame (100 px/s à 60 FPS)
+static constexpr int GRID_SIZE = 256;
+static constexpr float TILE_SIZE = 32.0f;
+static constexpr float SOLID_RATIO = 0.35f;
+static constexpr int GRID_QUERY_COUNT = 200000;
+static constexpr int CHECK_QUERY_COUNT = 2000;     // vérifiées contre la force brute
+static constexpr float PLAYER_WIDTH = 22.0f;
+static constexpr float PLAYER_HEIGHT = 8.0f;
+static constexpr float FRAME_STEP = 100.0f / 60.0f;
+
+struct BoxSet {
+    std::vector<float> minX, minY, maxX, maxY;
+    std::vector<Rectangle> rects;
+};
+
+static BoxSet GenerateBoxes(std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(0.0f, 4096.0f);
+    std::uniform_real_distribution<float> size(4.0f, 64.0f);
+
+    BoxSet boxes;
+    for (int i = 0; i < BOX_COUNT; ++i) {
+        Rectangle r = {position(rng), position(rng), size(rng), size(rng)};
+        boxes.rects.push_back(r);
+        boxes.minX.push_back(r.x);
+        boxes.minY.push_back(r.y);
+        boxes.maxX.push_back(r.x + r.width);
+        boxes.maxY.push_back(r.y + r.height);
+    }
+    return boxes;
+}
+
+// Carte de tuiles dont une partie porte une collision, générée par
+// CollisionSystem::GenerateCollisions comme au chargement d'une carte
+static TMJMap GenerateMap(std::mt19937& rng) {
+    TMJMap map;
+    map.width = GRID_SIZE;
+    map.height = GRID_SIZE;
+    map.tileWidth = (int)TILE_SIZE;
+    map.tileHeight = (int)TILE_SIZE;
+
+    // Gabarits : tuile pleine, rectangles plus petits dont un déborde sur la
+    // voisine, ellipse et triangle pour la phase fine
+    const float t = TILE_SIZE;
+    std::vector<CollisionShape> templates(6);
+    templates[0].type = ShapeType::Rectangle;
+    templates[0].rect = {0, 0, t, t};
+    templates[1].type = ShapeType::Rectangle;
+    templates[1].rect = {4, 6, t - 8, t - 10};
+    templates[2].type = ShapeType::Rectangle;
+    templates[2].rect = {0, t / 2, t, t / 2};
+    templates[3].type = ShapeType::Rectangle;
+    templates[3].rect = {8, 2, t, t - 6};
+    templates[4].type = ShapeType::Ellipse;
+    templates[4].rect = {2, 2, t - 4, t - 4};
+    templates[5].type = ShapeType::Polygon;
+    templates[5].points = {{0, t}, {t / 2, 0}, {t, t}};
+
+    TileSet tileset;
+    tileset.firstGid = 1;
+    tileset.tileCount = (int)templates.size();
+    tileset.tileWidth = (int)t;
+    tileset.tileHeight = (int)t;
+    map.tilesets.push_back(tileset);
+
+    map.tileCollisions.byGid.resize(templates.size() + 1);
+    for (size_t i = 0; i < templates.size(); ++i) {
+        map.tileCollisions.byGid[i + 1] = {(int)i, 1};
+    }
+    map.tileCollisions.shapes = templates;
+
+    // Les rectangles pleins dominent, comme sur une carte réelle
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    std::discrete_distribution<int> shape({50, 15, 15, 10, 5, 5});
+    TileLayer layer;
+    layer.width = GRID_SIZE;
+    layer.height = GRID_SIZE;
+    layer.data.assign((size_t)GRID_SIZE * GRID_SIZE, 0);
+    for (int& gid : layer.data) {
+        if (chance(rng) < SOLID_RATIO) gid = 1 + shape(rng);
+    }
+    map.layers.push_back(std::move(layer));
+    return map;
+}
+
+// Hitbox du joueur étendue par son déplacement sur un axe, comme dans
+// CollisionSystem::SweepRect
+static std::vector<Rectangle> GeneratePlayerQueries(std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(0.0f, GRID_SIZE * TILE_SIZE - PLAYER_WIDTH);
+    std::uniform_int_distribution<int> axis(0, 1);
+
+    std::vector<Rectangle> queries;
+    for (int i = 0; i < GRID_QUERY_COUNT; ++i) {
+        Rectangle query = {position(rng), position(rng), PLAYER_WIDTH, PLAYER_HEIGHT};
+        if (axis(rng)) query.width += FRAME_STEP;
+        else query.height += FRAME_STEP;
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+//==============================================================================
+// RUNNERS
+//==============================================================================
+static long long RunRecs(const BoxSet& boxes, const std::vector<Rectangle>& queries) {
+    long long hits = 0;
+    for (const auto& query : queries) {
+        for (const auto& rect : boxes.rects) {
+            hits += CheckCollisionRecs(query, rect) ? 1 : 0;
+        }
+    }
+    return hits;
+}
+
+static long long RunKernel(CollisionKernels::OverlapFn kernel, const BoxSet& boxes, const std::vector<Rectangle>& queries) {
+    long long hits = 0;
+    for (const auto& query : queries) {
+        for (int first = 0; first < BOX_COUNT; first += CollisionKernels::BATCH_SIZE) {
+            int count = BOX_COUNT - first < CollisionKernels::BATCH_SIZE ? BOX_COUNT - first : CollisionKernels::BATCH_SIZE;
+            uint32_t mask = kernel(query, &boxes.minX[first], &boxes.minY[first],
+                                   &boxes.maxX[first], &boxes.maxY[first], count);
+            while (mask) {
+                mask &= mask - 1;
+                ++hits;
+            }
+        }
+    }
+    return hits;
+}
+
+// Requêtes et balayages du jeu, sur le monde produit par GenerateCollisions
+static long long RunQueries(const CollisionWorld& world, const std::vector<Rectangle>& queries) {
+    std::vector<int> results;
+    long long hits = 0;
+    for (const auto& query : queries) {
+        CollisionSystem::QueryCollisions(world, query, results);
+        hits += (long long)results.size();
+    }
+    return hits;
+}
+
+// Hitbox du joueur (sans l'extension) déplacée d'un pas sur l'axe de la requête
+static long long RunSweeps(const CollisionWorld& world, const std::vector<Rectangle>& queries) {
+    long long hits = 0;
+    for (const auto& query : queries) {
+        Rectangle rect = {query.x, query.y, PLAYER_WIDTH, PLAYER_HEIGHT};
+        Vector2 delta = query.width > PLAYER_WIDTH ? Vector2{FRAME_STEP, 0.0f} : Vector2{0.0f, FRAME_STEP};
+        hits += CollisionSystem::SweepRect(world, rect, delta).hit ? 1 : 0;
+    }
+    return hits;
+}
+
+// Référence : toutes les formes testées une à une, pour vérifier la phase large
+static long long RunBruteForce(const CollisionWorld& world, const std::vector<Rectangle>& queries) {
+    const CollisionStore& store = world.store;
+    long long hits = 0;
+    for (const auto& query : queries) {
+        for (size_t i = 0; i < store.kind.size(); ++i) {
+            Rectangle box = {store.minX[i], store.minY[i], store.maxX[i] - store.minX[i], store.maxY[i] - store.minY[i]};
+            hits += CheckCollisionRecs(query, box) ? 1 : 0;
+        }
+    }
+    return hits;
+}
+
+template <typename Fn>
+static double Measure(Fn&& fn, long long& hits) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        hits = fn();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+static void Report(const char* name, double ms, long long hits, double baseline) {
+    double tests = (double)BOX_COUNT * QUERY_COUNT;
+    std::printf("%-18s %9.2f ms %8.3f ns/test  x%5.2f  (hits: %lld)\n",
+                name, ms, ms * 1e6 / tests, baseline / ms, hits);
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+int main() {
+    std::mt19937 rng(1234);
+    BoxSet boxes = GenerateBoxes(rng);
+
+    std::uniform_real_distribution<float> position(0.0f, 4096.0f);
+    std::vector<Rectangle> queries;
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        queries.push_back({position(rng), position(rng), 22.0f, 8.0f});
+    }
+
+    std::printf("Boxes: %d | Queries: %d | Active kernel: %s\n\n",
+                BOX_COUNT, QUERY_COUNT,
+                CollisionKernels::GetLevelName(CollisionKernels::GetActiveLevel()));
+
+    long long hits = 0;
+    double baseline = Measure([&] { return RunRecs(boxes, queries); }, hits);
+    Report("CheckCollisionRecs", baseline, hits, baseline);
+
+    const CollisionKernels::Level levels[] = {
+        CollisionKernels::Level::Scalar,
+        CollisionKernels::Level::SSE2,
+        CollisionKernels::Level::AVX2
+    };
+
+    for (auto level : levels) {
+        CollisionKernels::OverlapFn kernel = CollisionKernels::GetKernel(level);
+        if (!kernel) {
+            std::printf("%-18s unavailable on this CPU\n", CollisionKernels::GetLevelName(level));
+            continue;
+        }
+        double ms = Measure([&] { return RunKernel(kernel, boxes, queries); }, hits);
+        Report(CollisionKernels::GetLevelName(level), ms, hits, baseline);
+    }
+
+    //--------------------------------------------------------------------------
+    // CollisionSystem sur une carte générée, requêtes de la taille du joueur
+    //--------------------------------------------------------------------------
+    TMJMap map = GenerateMap(rng);
+    std::vector<Rectangle> playerQueries = GeneratePlayerQueries(rng);
+
+    // Le résumé affiché par GenerateCollisions fausserait la mesure
+    CollisionWorld world;
+    std::streambuf* log = std::cout.rdbuf(nullptr);
+    double generate = Measure([&] {
+        world = CollisionSystem::GenerateCollisions(map);
+        return (long long)world.store.kind.size();
+    }, hits);
+    std::cout.rdbuf(log);
+
+    std::printf("\nMap: %dx%d tiles | Shapes: %d (%d before merging) | Grid entries: %zu | Player queries: %d\n\n",
+                GRID_SIZE, GRID_SIZE, world.stats.bakedShapes, world.stats.generatedShapes,
+                world.grid.cellItems.size(), GRID_QUERY_COUNT);
+    std::printf("%-18s %9.2f ms\n", "GenerateCollisions", generate);
+
+    long long queryHits = 0, sweepHits = 0;
+    double query = Measure([&] { return RunQueries(world, playerQueries); }, queryHits);
+    double sweep = Measure([&] { return RunSweeps(world, playerQueries); }, sweepHits);
+
+    std::vector<Rectangle> checked(playerQueries.begin(), playerQueries.begin() + CHECK_QUERY_COUNT);
+    bool valid = RunQueries(world, checked) == RunBruteForce(world, checked);
+
+    std::printf("%-18s %9.2f ms %6.1f ns/query  (hits: %lld)%s\n", "QueryCollisions",
+                query, query * 1e6 / GRID_QUERY_COUNT, queryHits,
+                valid ? "" : "  HITS DIFFER FROM BRUTE FORCE");
+    std::printf("%-18s %9.2f ms %6.1f ns/sweep  (blocked: %lld)\n", "SweepRect",
+                sweep, sweep * 1e6 / GRID_QUERY_COUNT, sweepHits);
+
+    return valid ? 0 : 1;
+}
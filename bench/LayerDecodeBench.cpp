@@ -0,0 +1,515 @@
+// LayerDecodeBench.cpp - Compare le chargement de grandes couches CSV aux
+// données base64 (brutes et zlib), en TMJ et en TMX, après avoir vérifié le
+// décodeur DEFLATE sur tous ses chemins et sur des flux zlib/gzip de
+// référence, intacts puis altérés
+#include <raylib.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/Map/MapLoader.h"
+#include "../src/Core/Compression.h"
+
+//==============================================================================
+// CONFIGURATION
+//==============================================================================
+static constexpr int LAYER_SIZE = 1024;     // tuiles par côté
+static constexpr int LAYER_COUNT = 2;
+static constexpr int REPEATS = 5;
+
+// Sol en plaques de 8x8 tuiles + ~5 % de décor sur la seconde couche
+static std::vector<int> GenerateLayer(int index, std::mt19937& rng) {
+    std::vector<int> gids((size_t)LAYER_SIZE * LAYER_SIZE, 0);
+    std::uniform_int_distribution<int> chance(0, 99);
+    std::uniform_int_distribution<int> decor(20, 40);
+
+    for (int y = 0; y < LAYER_SIZE; ++y) {
+        for (int x = 0; x < LAYER_SIZE; ++x) {
+            int& gid = gids[(size_t)y * LAYER_SIZE + x];
+            if (index == 0) gid = 1 + ((x / 8) * 7 + (y / 8) * 3) % 12;
+            else if (chance(rng) < 5) gid = decor(rng);
+        }
+    }
+    return gids;
+}
+
+//==============================================================================
+// ENCODAGE
+//==============================================================================
+static std::string EncodeBase64(const unsigned char* data, size_t size) {
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string text;
+    text.reserve((size + 2) / 3 * 4);
+    for (size_t i = 0; i < size; i += 3) {
+        unsigned int chunk = (unsigned int)data[i] << 16;
+        if (i + 1 < size) chunk |= (unsigned int)data[i + 1] << 8;
+        if (i + 2 < size) chunk |= data[i + 2];
+        text += alphabet[(chunk >> 18) & 63];
+        text += alphabet[(chunk >> 12) & 63];
+        text += i + 1 < size ? alphabet[(chunk >> 6) & 63] : '=';
+        text += i + 2 < size ? alphabet[chunk & 63] : '=';
+    }
+    return text;
+}
+
+// CompressData de raylib produit du DEFLATE brut (blocs dynamiques)
+static std::vector<unsigned char> DeflateRaw(const unsigned char* data, size_t size) {
+    int compressedSize = 0;
+    unsigned char* compressed = CompressData(data, (int)size, &compressedSize);
+    std::vector<unsigned char> stream(compressed, compressed + compressedSize);
+    MemFree(compressed);
+    return stream;
+}
+
+// Blocs stockés (niveau 0), découpés à 65535 octets comme le ferait zlib
+static std::vector<unsigned char> DeflateStored(const unsigned char* data, size_t size) {
+    std::vector<unsigned char> stream;
+    size_t offset = 0;
+    do {
+        size_t length = std::min<size_t>(size - offset, 65535);
+        bool last = offset + length == size;
+        stream.push_back(last ? 1 : 0);    // BFINAL + BTYPE=00, aligné sur l'octet
+        stream.push_back((unsigned char)length);
+        stream.push_back((unsigned char)(length >> 8));
+        stream.push_back((unsigned char)~length);
+        stream.push_back((unsigned char)(~length >> 8));
+        stream.insert(stream.end(), data + offset, data + offset + length);
+        offset += length;
+    } while (offset < size);
+    return stream;
+}
+
+// Un bloc à codes fixes (BTYPE=01) de littéraux seuls
+static std::vector<unsigned char> DeflateFixed(const unsigned char* data, size_t size) {
+    std::vector<unsigned char> stream;
+    unsigned int buffer = 0;
+    int bits = 0;
+    auto put = [&](unsigned int value, int count) {
+        buffer |= value << bits;
+        bits += count;
+        while (bits >= 8) {
+            stream.push_back((unsigned char)buffer);
+            buffer >>= 8;
+            bits -= 8;
+        }
+    };
+    // Les codes de Huffman s'écrivent bit de poids fort en premier
+    auto putCode = [&](unsigned int code, int length) {
+        unsigned int reversed = 0;
+        for (int i = 0; i < length; ++i) reversed |= ((code >> i) & 1) << (length - 1 - i);
+        put(reversed, length);
+    };
+
+    put(1, 1);    // BFINAL
+    put(1, 2);    // BTYPE=01
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] < 144) putCode(0x30 + data[i], 8);
+        else putCode(0x190 + data[i] - 144, 9);
+    }
+    putCode(0, 7);    // fin de bloc
+    if (bits > 0) stream.push_back((unsigned char)buffer);
+    return stream;
+}
+
+// Sommes de contrôle recalculées ici, indépendamment du décodeur testé
+static unsigned int Adler32(const unsigned char* data, size_t size) {
+    unsigned int a = 1, b = 0;
+    for (size_t i = 0; i < size; ++i) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+static unsigned int Crc32(const unsigned char* data, size_t size) {
+    unsigned int crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+// En-tête zlib et Adler-32 attendus par Tiled
+static std::vector<unsigned char> WrapZlib(const std::vector<unsigned char>& raw, const unsigned char* data, size_t size) {
+    std::vector<unsigned char> stream = {0x78, 0x9C};
+    stream.insert(stream.end(), raw.begin(), raw.end());
+    unsigned int adler = Adler32(data, size);
+    for (int shift = 24; shift >= 0; shift -= 8) stream.push_back((unsigned char)(adler >> shift));
+    return stream;
+}
+
+// En-tête gzip (avec nom de fichier, comme gzip en ligne de commande), CRC-32 et taille
+static std::vector<unsigned char> WrapGzip(const std::vector<unsigned char>& raw, const unsigned char* data, size_t size) {
+    std::vector<unsigned char> stream = {0x1F, 0x8B, 8, 0x08, 0, 0, 0, 0, 0, 0xFF};
+    for (const char* name = "layer.bin"; ; ++name) {
+        stream.push_back((unsigned char)*name);
+        if (*name == '\0') break;
+    }
+    stream.insert(stream.end(), raw.begin(), raw.end());
+    unsigned int crc = Crc32(data, size);
+    for (int shift = 0; shift < 32; shift += 8) stream.push_back((unsigned char)(crc >> shift));
+    for (int shift = 0; shift < 32; shift += 8) stream.push_back((unsigned char)(size >> shift));
+    return stream;
+}
+
+static std::string EncodeLayer(const std::vector<int>& gids, const std::string& compression) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(gids.data());
+    size_t size = gids.size() * sizeof(int);
+    if (compression == "zlib") {
+        std::vector<unsigned char> stream = WrapZlib(DeflateRaw(bytes, size), bytes, size);
+        return EncodeBase64(stream.data(), stream.size());
+    }
+    return EncodeBase64(bytes, size);
+}
+
+static std::string JoinCSV(const std::vector<int>& gids) {
+    std::string text;
+    text.reserve(gids.size() * 3);
+    for (size_t i = 0; i < gids.size(); ++i) {
+        if (i > 0) text += ',';
+        text += std::to_string(gids[i]);
+    }
+    return text;
+}
+
+//==============================================================================
+// VÉRIFICATION DU DÉCODEUR
+//==============================================================================
+// Aller-retour sur chaque type de bloc et chaque conteneur. Les données
+// aléatoires à distribution très inégale donnent des codes de Huffman plus
+// longs que la table rapide du décodeur ; une somme de contrôle ou un flux
+// altérés doivent être refusés.
+static bool Inflates(const std::vector<unsigned char>& stream, Compression::Container container,
+                     const std::vector<unsigned char>& expected) {
+    std::vector<unsigned char> output(expected.size());
+    size_t written = 0;
+    return Compression::Inflate(stream.data(), stream.size(), container, output.data(), output.size(), written) &&
+           written == expected.size() && std::memcmp(output.data(), expected.data(), written) == 0;
+}
+
+static bool CheckInflate(const std::vector<int>& layer, std::mt19937& rng) {
+    using Container = Compression::Container;
+
+    std::vector<std::pair<const char*, std::vector<unsigned char>>> inputs;
+    const unsigned char* tiles = reinterpret_cast<const unsigned char*>(layer.data());
+    inputs.push_back({"tiles", std::vector<unsigned char>(tiles, tiles + 256 * 1024)});
+
+    std::vector<unsigned char> noise(100000);
+    for (auto& byte : noise) byte = (unsigned char)rng();
+    inputs.push_back({"noise", noise});
+
+    std::geometric_distribution<int> skew(0.25);
+    std::vector<unsigned char> skewed(200000);
+    for (auto& byte : skewed) byte = (unsigned char)std::min(skew(rng), 255);
+    inputs.push_back({"skewed", skewed});
+
+    bool allValid = true;
+    auto report = [&](const char* block, const char* container, const char* data, bool valid) {
+        std::printf("inflate %-8s %-5s %-7s %s\n", block, container, data, valid ? "OK" : "FAILED");
+        allValid = allValid && valid;
+    };
+
+    for (const auto& [name, data] : inputs) {
+        struct Block {
+            const char* name;
+            std::vector<unsigned char> raw;
+        };
+        const Block blocks[] = {
+            {"dynamic", DeflateRaw(data.data(), data.size())},
+            {"stored",  DeflateStored(data.data(), data.size())},
+            {"fixed",   DeflateFixed(data.data(), data.size())},
+        };
+        for (const Block& block : blocks) {
+            report(block.name, "raw", name, Inflates(block.raw, Container::Raw, data));
+            report(block.name, "zlib", name, Inflates(WrapZlib(block.raw, data.data(), data.size()), Container::Zlib, data));
+            report(block.name, "gzip", name, Inflates(WrapGzip(block.raw, data.data(), data.size()), Container::Gzip, data));
+        }
+    }
+
+    // Flux altérés : somme de contrôle, taille, troncature
+    const std::vector<unsigned char>& data = inputs[0].second;
+    std::vector<unsigned char> raw = DeflateRaw(data.data(), data.size());
+
+    std::vector<unsigned char> badAdler = WrapZlib(raw, data.data(), data.size());
+    badAdler.back() ^= 1;
+    std::vector<unsigned char> badCrc = WrapGzip(raw, data.data(), data.size());
+    badCrc[badCrc.size() - 8] ^= 1;
+    std::vector<unsigned char> badSize = WrapGzip(raw, data.data(), data.size());
+    badSize[badSize.size() - 4] ^= 1;
+    std::vector<unsigned char> truncated(raw.begin(), raw.begin() + raw.size() / 2);
+
+    report("corrupt", "zlib", "adler", !Inflates(badAdler, Container::Zlib, data));
+    report("corrupt", "gzip", "crc", !Inflates(badCrc, Container::Gzip, data));
+    report("corrupt", "gzip", "size", !Inflates(badSize, Container::Gzip, data));
+    report("corrupt", "raw", "cut", !Inflates(truncated, Container::Raw, data));
+    return allValid;
+}
+
+//------------------------------------------------------------------------------
+// Flux de référence produits par zlib 1.2 (niveau 9, bloc dynamique) et gzip
+// (avec nom de fichier), indépendants des encodeurs ci-dessus. Ils décodent
+// une couche 32x32 de KnownLayer(), dont une tuile retournée (bit de poids fort).
+//------------------------------------------------------------------------------
+static const unsigned char KNOWN_ZLIB[] = {
+    0x78, 0xDA, 0xBD, 0x97, 0xDB, 0x0E, 0x83, 0x20, 0x0C, 0x40, 0xD5, 0xE9, 0xDC, 0xC5, 0x47, 0xEE,
+    0xF0, 0xB1, 0xFB, 0xF4, 0x69, 0x22, 0x09, 0x69, 0x86, 0x50, 0x5A, 0xF6, 0x70, 0x62, 0x7C, 0x3A,
+    0xB5, 0xD0, 0x8B, 0x62, 0x18, 0x86, 0x31, 0xE1, 0x01, 0xB8, 0x01, 0x5E, 0x80, 0x05, 0xB0, 0x25,
+    0xD8, 0x9D, 0x15, 0x30, 0x01, 0x46, 0x26, 0xBF, 0xFC, 0xE1, 0xDF, 0x3A, 0xF9, 0x5D, 0xE5, 0xF7,
+    0x73, 0xF8, 0x15, 0x21, 0xFF, 0x25, 0xBF, 0xDF, 0x99, 0x13, 0x8E, 0xF7, 0x37, 0xE0, 0x0E, 0x68,
+    0x3D, 0x2F, 0x9D, 0x89, 0x77, 0x06, 0x70, 0xF8, 0x03, 0x22, 0x5F, 0x54, 0xBF, 0x21, 0xD6, 0x0B,
+    0xC6, 0x2F, 0x18, 0xEB, 0x25, 0x92, 0xBB, 0x1F, 0xF6, 0x7C, 0x3E, 0x01, 0x1C, 0xE7, 0x25, 0x93,
+    0x78, 0xD7, 0xF3, 0x3D, 0xF5, 0xEF, 0x71, 0x7F, 0x26, 0x26, 0xBF, 0x2B, 0xE4, 0xAB, 0x54, 0x9F,
+    0x18, 0xBF, 0x6A, 0xB8, 0xAF, 0xAD, 0x7E, 0xCF, 0x54, 0x2F, 0x35, 0xFD, 0x44, 0x23, 0xFA, 0x19,
+    0xF6, 0xBC, 0xA0, 0x3F, 0x10, 0xFB, 0xE9, 0x95, 0xDF, 0x54, 0xF8, 0x17, 0x26, 0xBF, 0x68, 0xFC,
+    0xFE, 0x16, 0xBF, 0x25, 0xE4, 0x1F, 0xDB, 0x4F, 0x24, 0x73, 0xBE, 0xAE, 0xFC, 0x8E, 0xB8, 0x7F,
+    0x5C, 0xF9, 0x15, 0xF0, 0xAB, 0x0E, 0xFB, 0x4F, 0xF4, 0xFB, 0x3F, 0xEC, 0x3F, 0x11, 0x8D, 0xCC,
+    0x3F, 0xA5, 0x9F, 0x07, 0x86, 0x78, 0x6B, 0xFD, 0x86, 0xB8, 0x7F, 0x60, 0xFC, 0xA2, 0xC3, 0xFE,
+    0x13, 0xB1, 0xC0, 0x6F, 0x3B, 0xEC, 0x3F, 0xB9, 0x5A, 0xC5, 0xCC, 0x7F, 0x6C, 0x3F, 0x71, 0x8D,
+    0xF1, 0xB6, 0xF8, 0x15, 0x63, 0xBE, 0x4A, 0x7E, 0xDF, 0x61, 0xFF, 0x89, 0x68, 0xE0, 0xD6, 0x0C,
+    0xF3, 0x34, 0xE7, 0x0F, 0x84, 0xF9, 0x8F, 0x9D, 0x7F, 0x86, 0x30, 0xFF, 0xB1, 0x7E, 0xC1, 0xBC,
+    0x7F, 0x50, 0xFF, 0x67, 0xB9, 0xFC, 0xB2, 0xC3, 0xFE, 0x33, 0x83, 0x5A, 0x3D, 0xF8, 0x02, 0xB8,
+    0x56, 0x1D, 0x1E,
+};
+
+static const unsigned char KNOWN_GZIP[] = {
+    0x1F, 0x8B, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x02, 0xFF, 0x6C, 0x61, 0x79, 0x65, 0x72, 0x2E,
+    0x62, 0x69, 0x6E, 0x00, 0xBD, 0x97, 0xDB, 0x0E, 0x83, 0x20, 0x0C, 0x40, 0xD5, 0xE9, 0xDC, 0xC5,
+    0x47, 0xEE, 0xF0, 0xB1, 0xFB, 0xF4, 0x69, 0x22, 0x09, 0x69, 0x86, 0x50, 0x5A, 0xF6, 0x70, 0x62,
+    0x7C, 0x3A, 0xB5, 0xD0, 0x8B, 0x62, 0x18, 0x86, 0x31, 0xE1, 0x01, 0xB8, 0x01, 0x5E, 0x80, 0x05,
+    0xB0, 0x25, 0xD8, 0x9D, 0x15, 0x30, 0x01, 0x46, 0x26, 0xBF, 0xFC, 0xE1, 0xDF, 0x3A, 0xF9, 0x5D,
+    0xE5, 0xF7, 0x73, 0xF8, 0x15, 0x21, 0xFF, 0x25, 0xBF, 0xDF, 0x99, 0x13, 0x8E, 0xF7, 0x37, 0xE0,
+    0x0E, 0x68, 0x3D, 0x2F, 0x9D, 0x89, 0x77, 0x06, 0x70, 0xF8, 0x03, 0x22, 0x5F, 0x54, 0xBF, 0x21,
+    0xD6, 0x0B, 0xC6, 0x2F, 0x18, 0xEB, 0x25, 0x92, 0xBB, 0x1F, 0xF6, 0x7C, 0x3E, 0x01, 0x1C, 0xE7,
+    0x25, 0x93, 0x78, 0xD7, 0xF3, 0x3D, 0xF5, 0xEF, 0x71, 0x7F, 0x26, 0x26, 0xBF, 0x2B, 0xE4, 0xAB,
+    0x54, 0x9F, 0x18, 0xBF, 0x6A, 0xB8, 0xAF, 0xAD, 0x7E, 0xCF, 0x54, 0x2F, 0x35, 0xFD, 0x44, 0x23,
+    0xFA, 0x19, 0xF6, 0xBC, 0xA0, 0x3F, 0x10, 0xFB, 0xE9, 0x95, 0xDF, 0x54, 0xF8, 0x17, 0x26, 0xBF,
+    0x68, 0xFC, 0xFE, 0x16, 0xBF, 0x25, 0xE4, 0x1F, 0xDB, 0x4F, 0x24, 0x73, 0xBE, 0xAE, 0xFC, 0x8E,
+    0xB8, 0x7F, 0x5C, 0xF9, 0x15, 0xF0, 0xAB, 0x0E, 0xFB, 0x4F, 0xF4, 0xFB, 0x3F, 0xEC, 0x3F, 0x11,
+    0x8D, 0xCC, 0x3F, 0xA5, 0x9F, 0x07, 0x86, 0x78, 0x6B, 0xFD, 0x86, 0xB8, 0x7F, 0x60, 0xFC, 0xA2,
+    0xC3, 0xFE, 0x13, 0xB1, 0xC0, 0x6F, 0x3B, 0xEC, 0x3F, 0xB9, 0x5A, 0xC5, 0xCC, 0x7F, 0x6C, 0x3F,
+    0x71, 0x8D, 0xF1, 0xB6, 0xF8, 0x15, 0x63, 0xBE, 0x4A, 0x7E, 0xDF, 0x61, 0xFF, 0x89, 0x68, 0xE0,
+    0xD6, 0x0C, 0xF3, 0x34, 0xE7, 0x0F, 0x84, 0xF9, 0x8F, 0x9D, 0x7F, 0x86, 0x30, 0xFF, 0xB1, 0x7E,
+    0xC1, 0xBC, 0x7F, 0x50, 0xFF, 0x67, 0xB9, 0xFC, 0xB2, 0xC3, 0xFE, 0x33, 0x83, 0x5A, 0x3D, 0xF8,
+    0x02, 0x1A, 0x30, 0xB2, 0x46, 0x00, 0x10, 0x00, 0x00,
+};
+
+// Le flux DEFLATE brut est celui du conteneur zlib, sans en-tête ni Adler-32
+static constexpr size_t ZLIB_HEADER = 2;
+static constexpr size_t ZLIB_TRAILER = 4;
+
+static std::vector<unsigned char> KnownLayer() {
+    std::vector<int> gids;
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            unsigned int gid = 1 + ((x / 4) * 7 + (y / 4) * 3) % 12;
+            if ((x * 31 + y * 17) % 23 == 0) gid = 20 + (x + y) % 9;
+            if (x == 5 && y == 9) gid = 0x80000003u;
+            gids.push_back((int)gid);
+        }
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(gids.data());
+    return std::vector<unsigned char>(bytes, bytes + gids.size() * sizeof(int));
+}
+
+static bool DecodesBase64(const char* text, const std::vector<unsigned char>& expected) {
+    std::vector<unsigned char> output;
+    return Compression::DecodeBase64(text, std::strlen(text), output) && output == expected;
+}
+
+// Flux connus, puis altérés un à un : tronqués, en-tête ou données modifiés,
+// tampon de sortie trop petit. Aucun ne doit être accepté.
+static bool CheckKnownStreams() {
+    using Container = Compression::Container;
+
+    const std::vector<unsigned char> expected = KnownLayer();
+    const std::vector<unsigned char> zlib(std::begin(KNOWN_ZLIB), std::end(KNOWN_ZLIB));
+    const std::vector<unsigned char> gzip(std::begin(KNOWN_GZIP), std::end(KNOWN_GZIP));
+    const std::vector<unsigned char> raw(zlib.begin() + ZLIB_HEADER, zlib.end() - ZLIB_TRAILER);
+
+    bool allValid = true;
+    auto report = [&](const char* check, const char* container, bool valid) {
+        std::printf("known   %-14s %-5s %s\n", check, container, valid ? "OK" : "FAILED");
+        allValid = allValid && valid;
+    };
+
+    report("decode", "raw", Inflates(raw, Container::Raw, expected));
+    report("decode", "zlib", Inflates(zlib, Container::Zlib, expected));
+    report("decode", "gzip", Inflates(gzip, Container::Gzip, expected));
+
+    // Troncatures : dans l'en-tête, au milieu des données, dans la somme de contrôle
+    const struct {
+        const char* name;
+        const std::vector<unsigned char>* stream;
+        Container container;
+    } streams[] = {
+        {"raw", &raw, Container::Raw},
+        {"zlib", &zlib, Container::Zlib},
+        {"gzip", &gzip, Container::Gzip},
+    };
+    for (const auto& entry : streams) {
+        const std::vector<unsigned char>& stream = *entry.stream;
+        bool rejected = true;
+        for (size_t cut : {(size_t)1, (size_t)8, stream.size() / 2, stream.size() - 1}) {
+            std::vector<unsigned char> truncated(stream.begin(), stream.begin() + cut);
+            rejected = rejected && !Inflates(truncated, entry.container, expected);
+        }
+        report("truncated", entry.name, rejected);
+    }
+
+    // Un bit changé dans les données compressées
+    for (const auto& entry : streams) {
+        std::vector<unsigned char> corrupt = *entry.stream;
+        corrupt[corrupt.size() / 2] ^= 0x10;
+        report("corrupt data", entry.name, !Inflates(corrupt, entry.container, expected));
+    }
+
+    // En-têtes invalides : FCHECK zlib, signature gzip, type de bloc réservé (11)
+    std::vector<unsigned char> badCheck = zlib;
+    badCheck[1] ^= 1;
+    report("bad header", "zlib", !Inflates(badCheck, Container::Zlib, expected));
+    std::vector<unsigned char> badMagic = gzip;
+    badMagic[1] = 0x8C;
+    report("bad header", "gzip", !Inflates(badMagic, Container::Gzip, expected));
+    std::vector<unsigned char> badBlock = raw;
+    badBlock[0] |= 0x06;
+    report("bad block", "raw", !Inflates(badBlock, Container::Raw, expected));
+
+    // Couche plus grande que prévu : refusée, sans écrire hors du tampon
+    std::vector<unsigned char> tooSmall(expected.size() - sizeof(int));
+    size_t written = 0;
+    report("short output", "zlib", !Compression::Inflate(zlib.data(), zlib.size(), Container::Zlib,
+                                                         tooSmall.data(), tooSmall.size(), written));
+
+    // Base64 : remplissage, blancs de TMX, caractère invalide
+    const std::vector<unsigned char> small = {1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0, 1, 0, 0, 0x40};
+    report("base64", "plain", DecodesBase64("AQAAAAIAAAADAAAAAQAAQA==", small));
+    report("base64", "tmx", DecodesBase64("\n   AQAAAAIAAAAD\n   AAAAAQAAQA==\n  ", small));
+    std::vector<unsigned char> output;
+    report("base64", "bad", !Compression::DecodeBase64("AQAA*AIA", 8, output));
+    return allValid;
+}
+
+//==============================================================================
+// FICHIERS DE TEST
+//==============================================================================
+static void WriteTMJ(const std::string& path, const std::vector<std::vector<int>>& layers,
+                     const std::string& encoding, const std::string& compression) {
+    std::ofstream file(path, std::ios::binary);
+    file << "{\"width\":" << LAYER_SIZE << ",\"height\":" << LAYER_SIZE
+         << ",\"tilewidth\":16,\"tileheight\":16,\"tilesets\":[],\"layers\":[";
+
+    for (size_t i = 0; i < layers.size(); ++i) {
+        if (i > 0) file << ",";
+        file << "{";
+        if (!compression.empty()) file << "\"compression\":\"" << compression << "\",";
+        if (encoding == "csv") file << "\"data\":[" << JoinCSV(layers[i]) << "],";
+        else file << "\"data\":\"" << EncodeLayer(layers[i], compression) << "\",\"encoding\":\"base64\",";
+        file << "\"height\":" << LAYER_SIZE << ",\"name\":\"Layer " << i
+             << "\",\"type\":\"tilelayer\",\"width\":" << LAYER_SIZE << "}";
+    }
+    file << "]}";
+}
+
+static void WriteTMX(const std::string& path, const std::vector<std::vector<int>>& layers,
+                     const std::string& encoding, const std::string& compression) {
+    std::ofstream file(path, std::ios::binary);
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<map width=\"" << LAYER_SIZE << "\" height=\""
+         << LAYER_SIZE << "\" tilewidth=\"16\" tileheight=\"16\">\n";
+
+    for (size_t i = 0; i < layers.size(); ++i) {
+        file << " <layer name=\"Layer " << i << "\" width=\"" << LAYER_SIZE << "\" height=\"" << LAYER_SIZE << "\">\n"
+             << "  <data encoding=\"" << encoding << "\"";
+        if (!compression.empty()) file << " compression=\"" << compression << "\"";
+        file << ">\n";
+        if (encoding == "csv") file << JoinCSV(layers[i]);
+        else file << EncodeLayer(layers[i], compression);
+        file << "\n  </data>\n </layer>\n";
+    }
+    file << "</map>\n";
+}
+
+//==============================================================================
+// MESURE
+//==============================================================================
+static double Measure(const std::string& path, const std::vector<std::vector<int>>& expected, bool& valid) {
+    double best = 1e30;
+    valid = true;
+
+    // Le résumé affiché par LoadMap fausserait la mesure
+    std::streambuf* log = std::cout.rdbuf(nullptr);
+    for (int r = 0; r < REPEATS; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        TMJMap map;
+        if (!MapLoader::LoadMap(path, map)) valid = false;
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (ms < best) best = ms;
+
+        if (map.layers.size() != expected.size()) valid = false;
+        for (size_t i = 0; valid && i < expected.size(); ++i) {
+            valid = map.layers[i].data == expected[i];
+        }
+    }
+    std::cout.rdbuf(log);
+    return best;
+}
+
+static long long FileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return (long long)file.tellg();
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+int main() {
+    SetTraceLogLevel(LOG_WARNING);
+
+    std::mt19937 rng(1234);
+    std::vector<std::vector<int>> layers;
+    for (int i = 0; i < LAYER_COUNT; ++i) layers.push_back(GenerateLayer(i, rng));
+
+    struct Case {
+        const char* name;
+        const char* path;
+        bool tmx;
+        const char* encoding;
+        const char* compression;
+    };
+    const Case cases[] = {
+        {"TMJ csv",         "layer_bench_csv.tmj",  false, "csv",    ""},
+        {"TMJ base64",      "layer_bench_b64.tmj",  false, "base64", ""},
+        {"TMJ base64+zlib", "layer_bench_zlib.tmj", false, "base64", "zlib"},
+        {"TMX csv",         "layer_bench_csv.tmx",  true,  "csv",    ""},
+        {"TMX base64",      "layer_bench_b64.tmx",  true,  "base64", ""},
+        {"TMX base64+zlib", "layer_bench_zlib.tmx", true,  "base64", "zlib"},
+    };
+
+    bool inflateValid = CheckInflate(layers[0], rng);
+    inflateValid = CheckKnownStreams() && inflateValid;
+    std::printf("\nLayers: %d x %dx%d tiles\n\n", LAYER_COUNT, LAYER_SIZE, LAYER_SIZE);
+
+    double baseline = 0.0;
+    for (const Case& test : cases) {
+        if (test.tmx) WriteTMX(test.path, layers, test.encoding, test.compression);
+        else WriteTMJ(test.path, layers, test.encoding, test.compression);
+
+        bool valid = false;
+        double ms = Measure(test.path, layers, valid);
+        if (std::string(test.encoding) == "csv") baseline = ms;    // référence : CSV du même format
+
+        std::printf("%-16s %9.2f ms  x%6.2f  %9.1f KB  %s\n", test.name, ms, baseline / ms,
+                    FileSize(test.path) / 1024.0, valid ? "OK" : "MISMATCH");
+        std::remove(test.path);
+    }
+
+    return inflateValid ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <climits>
+
+AtlasPacker::AtlasPacker(int pageWidth, int pageHeight, int padding)
+    : m_pageWidth(pageWidth), m_pageHeight(pageHeight), m_padding(padding) {}
+
+//==============================================================================
+// PACK
+//==============================================================================
+std::vector<AtlasPacker::Placement> AtlasPacker::Pack(const std::vector<Size>& sizes) {
+    std::vector<Placement> placements(sizes.size());
+
+    // Tallest first keeps the skyline flat
+    std::vector<int> order(sizes.size());
+    for (int i = 0; i < (int)order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        if (sizes[a].height != sizes[b].height) return sizes[a].height > sizes[b].height;
+        return sizes[a].width > sizes[b].width;
+    });
+
+    for (int index : order) {
+        int width = sizes[index].width + m_padding;
+        int height = sizes[index].height + m_padding;
+        if (sizes[index].width <= 0 || sizes[index].height <= 0 ||
+            width > m_pageWidth || height > m_pageHeight) {
+            continue;
+        }
+
+        Placement& placement = placements[index];
+        for (int page = 0; page < (int)m_pages.size() && placement.page < 0; ++page) {
+            if (Insert(m_pages[page], width, height, placement.x, placement.y)) {
+                placement.page = page;
+            }
+        }
+
+        if (placement.page < 0) {
+            m_pages.push_back({{{0, 0, m_pageWidth}}});
+            Insert(m_pages.back(), width, height, placement.x, placement.y);
+            placement.page = (int)m_pages.size() - 1;
+        }
+    }
+
+    return placements;
+}
+
+AtlasPacker::Size AtlasPacker::GetUsedSize(int page) const {
+    return {m_pages[page].usedWidth, m_pages[page].usedHeight};
+}
+
+//==============================================================================
+// SKYLINE
+//==============================================================================
+// Lowest y at which a width x height rectangle can rest with its left edge on
+// skyline node `index`, or -1 if it would leave the page.
+int AtlasPacker::FitAt(const Page& page, int index, int width, int height) const {
+    const auto& skyline = page.skyline;
+    int x = skyline[index].x;
+    if (x + width > m_pageWidth) return -1;
+
+    int y = 0;
+    int remaining = width;
+    for (int i = index; remaining > 0 && i < (int)skyline.size(); ++i) {
+        y = std::max(y, skyline[i].y);
+        if (y + height > m_pageHeight) return -1;
+        remaining -= skyline[i].width;
+    }
+    return y;
+}
+
+bool AtlasPacker::Insert(Page& page, int width, int height, int& x, int& y) {
+    auto& skyline = page.skyline;
+
+    // Bottom-left: lowest top edge, then narrowest node
+    int best = -1;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    for (int i = 0; i < (int)skyline.size(); ++i) {
+        int fitY = FitAt(page, i, width, height);
+        if (fitY < 0) continue;
+
+        int top = fitY + height;
+        if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+            best = i;
+            bestTop = top;
+            bestWidth = skyline[i].width;
+            y = fitY;
+        }
+    }
+    if (best < 0) return false;
+
+    x = skyline[best].x;
+    skyline.insert(skyline.begin() + best, {x, y + height, width});
+
+    // Trim the nodes now covered by the new one
+    for (int i = best + 1; i < (int)skyline.size(); ++i) {
+        int coveredEnd = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= coveredEnd) break;
+
+        int shrink = coveredEnd - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0) break;
+
+        skyline.erase(skyline.begin() + i);
+        --i;
+    }
+
+    // Merge neighbours at the same height
+    for (int i = 0; i + 1 < (int)skyline.size(); ++i) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+            --i;
+        }
+    }
+
+    page.usedWidth = std::max(page.usedWidth, x + width);
+    page.usedHeight = std::max(page.usedHeight, y + height);
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+
+//==============================================================================
+// ATLAS PACKER
+//==============================================================================
+// Skyline bottom-left rectangle packer. Rectangles are placed tallest first
+// into fixed-size pages; a new page is opened when one no longer fits.
+// Only computes placements, the caller copies the pixels.
+class AtlasPacker {
+public:
+    struct Size {
+        int width;
+        int height;
+    };
+
+    struct Placement {
+        int page = -1;    // -1 when larger than a page
+        int x = 0;
+        int y = 0;
+    };
+
+    AtlasPacker(int pageWidth, int pageHeight, int padding = 0);
+
+    std::vector<Placement> Pack(const std::vector<Size>& sizes);
+
+    int GetPageCount() const { return (int)m_pages.size(); }
+    Size GetUsedSize(int page) const;
+
+private:
+    struct SkylineNode {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page {
+        std::vector<SkylineNode> skyline;
+        int usedWidth = 0;
+        int usedHeight = 0;
+    };
+
+    int m_pageWidth;
+    int m_pageHeight;
+    int m_padding;
+    std::vector<Page> m_pages;
+
+    bool Insert(Page& page, int width, int height, int& x, int& y);
+    int FitAt(const Page& page, int index, int width, int height) const;
+};
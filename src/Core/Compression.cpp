@@ -0,0 +1,408 @@
+#include "Compression.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#ifdef RPG_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+//==============================================================================
+// BASE64
+//==============================================================================
+// Whitespace (TMX wraps the text in newlines and indentation) is skipped
+bool Compression::DecodeBase64(const char* text, size_t length, std::vector<unsigned char>& output) {
+    static const std::array<int8_t, 256> s_values = [] {
+        std::array<int8_t, 256> values;
+        values.fill(-1);
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i) values[(unsigned char)alphabet[i]] = (int8_t)i;
+        return values;
+    }();
+
+    output.resize(length / 4 * 3 + 3);
+    unsigned char* cursor = output.data();
+
+    uint32_t accumulator = 0;
+    int bits = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = (unsigned char)text[i];
+        int value = s_values[c];
+        if (value < 0) {
+            if (c == '=') break;
+            if (c == ' ' || c == '\n' || c == '\r' || c == '\t') continue;
+            output.clear();
+            return false;
+        }
+
+        accumulator = (accumulator << 6) | (uint32_t)value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            *cursor++ = (unsigned char)(accumulator >> bits);
+        }
+    }
+
+    output.resize((size_t)(cursor - output.data()));
+    return true;
+}
+
+//==============================================================================
+// INFLATE (RFC 1951)
+//==============================================================================
+namespace {
+
+    constexpr int MAX_BITS = 15;
+    constexpr int FAST_BITS = 10;
+
+    // Canonical Huffman decoder. Codes up to FAST_BITS long resolve with one
+    // table lookup (entry = length << 9 | symbol, 0 when longer); longer codes
+    // fall back to a canonical walk.
+    struct Huffman {
+        uint16_t fast[1 << FAST_BITS];
+        uint16_t counts[MAX_BITS + 1];
+        uint16_t symbols[288];
+
+        bool Build(const uint8_t* lengths, int count) {
+            std::memset(counts, 0, sizeof(counts));
+            std::memset(fast, 0, sizeof(fast));
+            for (int i = 0; i < count; ++i) counts[lengths[i]]++;
+            counts[0] = 0;
+
+            int left = 1;
+            for (int len = 1; len <= MAX_BITS; ++len) {
+                left = (left << 1) - counts[len];
+                if (left < 0) return false;    // over-subscribed
+            }
+
+            uint16_t offsets[MAX_BITS + 2];
+            offsets[1] = 0;
+            for (int len = 1; len <= MAX_BITS; ++len) offsets[len + 1] = offsets[len] + counts[len];
+            for (int i = 0; i < count; ++i) {
+                if (lengths[i]) symbols[offsets[lengths[i]]++] = (uint16_t)i;
+            }
+
+            // Codes are read LSB-first: index the table by the reversed code
+            int code = 0;
+            int index = 0;
+            for (int len = 1; len <= FAST_BITS; ++len) {
+                for (int k = 0; k < counts[len]; ++k, ++code, ++index) {
+                    int reversed = 0;
+                    for (int b = 0; b < len; ++b) reversed |= ((code >> b) & 1) << (len - 1 - b);
+                    for (int slot = reversed; slot < (1 << FAST_BITS); slot += 1 << len) {
+                        fast[slot] = (uint16_t)((len << 9) | symbols[index]);
+                    }
+                }
+                code <<= 1;
+            }
+            return true;
+        }
+    };
+
+    class BitReader {
+    public:
+        BitReader(const uint8_t* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+        void Refill() {
+            while (m_count <= 56) {
+                uint64_t byte = 0;
+                if (m_cursor < m_end) byte = *m_cursor++;
+                else m_padding += 8;
+                m_buffer |= byte << m_count;
+                m_count += 8;
+            }
+        }
+
+        uint32_t Peek(int bits) { Refill(); return (uint32_t)(m_buffer & ((1ull << bits) - 1)); }
+        void Consume(int bits) { m_buffer >>= bits; m_count -= bits; }
+
+        uint32_t Get(int bits) {
+            if (bits == 0) return 0;
+            uint32_t value = Peek(bits);
+            Consume(bits);
+            return value;
+        }
+
+        void AlignToByte() { Consume(m_count & 7); }
+
+        // True once bits past the end of the input were consumed
+        bool Overrun() const { return m_count < m_padding; }
+
+        // Input bytes actually used, excluding look-ahead still in the buffer
+        size_t Consumed(const uint8_t* start) const {
+            return (size_t)(m_cursor - start) - (size_t)((m_count - m_padding) / 8);
+        }
+
+    private:
+        const uint8_t* m_cursor;
+        const uint8_t* m_end;
+        uint64_t m_buffer = 0;
+        int m_count = 0;
+        int m_padding = 0;
+    };
+
+    int DecodeSymbol(BitReader& reader, const Huffman& huffman) {
+        uint32_t bits = reader.Peek(MAX_BITS);
+        uint16_t entry = huffman.fast[bits & ((1 << FAST_BITS) - 1)];
+        if (entry) {
+            reader.Consume(entry >> 9);
+            return entry & 0x1FF;
+        }
+
+        // Canonical walk for codes longer than FAST_BITS
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len <= MAX_BITS; ++len) {
+            code |= (bits >> (len - 1)) & 1;
+            int count = huffman.counts[len];
+            if (code - first < count) {
+                reader.Consume(len);
+                return huffman.symbols[index + (code - first)];
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+    constexpr uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                          35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                          3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    constexpr uint16_t DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                            193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+                                            4097, 6145, 8193, 12289, 16385, 24577};
+    constexpr uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    bool BuildFixed(Huffman& literals, Huffman& distances) {
+        uint8_t lengths[288];
+        for (int i = 0; i < 144; ++i) lengths[i] = 8;
+        for (int i = 144; i < 256; ++i) lengths[i] = 9;
+        for (int i = 256; i < 280; ++i) lengths[i] = 7;
+        for (int i = 280; i < 288; ++i) lengths[i] = 8;
+        if (!literals.Build(lengths, 288)) return false;
+
+        for (int i = 0; i < 30; ++i) lengths[i] = 5;
+        return distances.Build(lengths, 30);
+    }
+
+    bool BuildDynamic(BitReader& reader, Huffman& literals, Huffman& distances) {
+        static constexpr uint8_t ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        int literalCount = (int)reader.Get(5) + 257;
+        int distanceCount = (int)reader.Get(5) + 1;
+        int codeCount = (int)reader.Get(4) + 4;
+        if (literalCount > 286 || distanceCount > 30) return false;
+
+        uint8_t lengths[288 + 32] = {0};
+        for (int i = 0; i < codeCount; ++i) lengths[ORDER[i]] = (uint8_t)reader.Get(3);
+
+        Huffman codeLengths;
+        if (!codeLengths.Build(lengths, 19)) return false;
+
+        std::memset(lengths, 0, sizeof(lengths));
+        int index = 0;
+        while (index < literalCount + distanceCount) {
+            int symbol = DecodeSymbol(reader, codeLengths);
+            if (symbol < 0 || reader.Overrun()) return false;
+
+            if (symbol < 16) {
+                lengths[index++] = (uint8_t)symbol;
+                continue;
+            }
+
+            uint8_t value = 0;
+            int repeat;
+            if (symbol == 16) {
+                if (index == 0) return false;
+                value = lengths[index - 1];
+                repeat = 3 + (int)reader.Get(2);
+            } else if (symbol == 17) {
+                repeat = 3 + (int)reader.Get(3);
+            } else {
+                repeat = 11 + (int)reader.Get(7);
+            }
+            if (index + repeat > literalCount + distanceCount) return false;
+            while (repeat--) lengths[index++] = value;
+        }
+
+        if (lengths[256] == 0) return false;    // no end-of-block code
+        return literals.Build(lengths, literalCount) &&
+               distances.Build(lengths + literalCount, distanceCount);
+    }
+}
+
+bool Compression::InflateRaw(const unsigned char* input, size_t inputSize, size_t& consumed,
+                             unsigned char* output, size_t outputSize, size_t& written) {
+    BitReader reader(input, inputSize);
+    Huffman literals, distances;
+    size_t position = 0;
+    bool last = false;
+
+    while (!last) {
+        last = reader.Get(1) != 0;
+        int type = (int)reader.Get(2);
+
+        if (type == 0) {
+            // Stored block
+            reader.AlignToByte();
+            uint32_t length = reader.Get(16);
+            uint32_t complement = reader.Get(16);
+            if ((length ^ 0xFFFF) != complement || length > outputSize - position) return false;
+            for (uint32_t i = 0; i < length; ++i) output[position++] = (unsigned char)reader.Get(8);
+            if (reader.Overrun()) return false;
+            continue;
+        }
+
+        if (type == 1) {
+            if (!BuildFixed(literals, distances)) return false;
+        } else if (type == 2) {
+            if (!BuildDynamic(reader, literals, distances)) return false;
+        } else {
+            return false;
+        }
+
+        for (;;) {
+            int symbol = DecodeSymbol(reader, literals);
+            if (symbol < 0 || reader.Overrun()) return false;
+
+            if (symbol < 256) {
+                if (position >= outputSize) return false;
+                output[position++] = (unsigned char)symbol;
+                continue;
+            }
+            if (symbol == 256) break;
+
+            symbol -= 257;
+            if (symbol >= 29) return false;
+            size_t length = LENGTH_BASE[symbol] + reader.Get(LENGTH_EXTRA[symbol]);
+
+            int distanceSymbol = DecodeSymbol(reader, distances);
+            if (distanceSymbol < 0 || distanceSymbol >= 30) return false;
+            size_t distance = DISTANCE_BASE[distanceSymbol] + reader.Get(DISTANCE_EXTRA[distanceSymbol]);
+
+            if (distance > position || length > outputSize - position) return false;
+
+            unsigned char* target = output + position;
+            const unsigned char* source = target - distance;
+            if (distance >= length) {
+                std::memcpy(target, source, length);
+            } else {
+                // Overlapping copy repeats the last `distance` bytes
+                for (size_t i = 0; i < length; ++i) target[i] = source[i];
+            }
+            position += length;
+        }
+    }
+
+    if (reader.Overrun()) return false;
+    consumed = reader.Consumed(input);
+    written = position;
+    return true;
+}
+
+//==============================================================================
+// CONTAINERS
+//==============================================================================
+static uint32_t Adler32(const unsigned char* data, size_t size) {
+    uint32_t a = 1, b = 0;
+    while (size > 0) {
+        size_t block = size < 5552 ? size : 5552;
+        size -= block;
+        while (block--) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static uint32_t Crc32(const unsigned char* data, size_t size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            entries[i] = crc;
+        }
+        return entries;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool Compression::Inflate(const unsigned char* input, size_t inputSize, Container container,
+                          unsigned char* output, size_t outputSize, size_t& written) {
+    size_t header = 0;
+
+    if (container == Container::Zlib) {
+        if (inputSize < 6) return false;
+        unsigned char cmf = input[0], flags = input[1];
+        if ((cmf & 0x0F) != 8 || ((cmf << 8) | flags) % 31 != 0 || (flags & 0x20)) return false;
+        header = 2;
+    }
+    else if (container == Container::Gzip) {
+        if (inputSize < 18 || input[0] != 0x1F || input[1] != 0x8B || input[2] != 8) return false;
+        unsigned char flags = input[3];
+        header = 10;
+        if (flags & 0x04) header += 2 + (input[10] | (input[11] << 8));    // FEXTRA
+        if (flags & 0x08) { while (header < inputSize && input[header]) ++header; ++header; }   // FNAME
+        if (flags & 0x10) { while (header < inputSize && input[header]) ++header; ++header; }   // FCOMMENT
+        if (flags & 0x02) header += 2;                                      // FHCRC
+        if (header >= inputSize) return false;
+    }
+
+    size_t consumed = 0;
+    if (!InflateRaw(input + header, inputSize - header, consumed, output, outputSize, written)) return false;
+
+    const unsigned char* trailer = input + header + consumed;
+    size_t trailerSize = inputSize - header - consumed;
+
+    if (container == Container::Zlib) {
+        if (trailerSize < 4) return false;
+        uint32_t expected = ((uint32_t)trailer[0] << 24) | ((uint32_t)trailer[1] << 16) |
+                            ((uint32_t)trailer[2] << 8) | trailer[3];
+        return Adler32(output, written) == expected;
+    }
+    if (container == Container::Gzip) {
+        if (trailerSize < 8) return false;
+        uint32_t crc = (uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8) |
+                       ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+        uint32_t size = (uint32_t)trailer[4] | ((uint32_t)trailer[5] << 8) |
+                        ((uint32_t)trailer[6] << 16) | ((uint32_t)trailer[7] << 24);
+        return size == (uint32_t)written && Crc32(output, written) == crc;
+    }
+    return true;
+}
+
+//==============================================================================
+// ZSTD
+//==============================================================================
+bool Compression::HasZstd() {
+#ifdef RPG_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Compression::DecompressZstd(const unsigned char* input, size_t inputSize,
+                                 unsigned char* output, size_t outputSize, size_t& written) {
+#ifdef RPG_HAVE_ZSTD
+    size_t result = ZSTD_decompress(output, outputSize, input, inputSize);
+    if (ZSTD_isError(result)) return false;
+    written = result;
+    return true;
+#else
+    (void)input; (void)inputSize; (void)output; (void)outputSize;
+    written = 0;
+    return false;
+#endif
+}
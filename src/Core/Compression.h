@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+//==============================================================================
+// COMPRESSION
+//==============================================================================
+// Decoders for Tiled's encoded layer data: base64, DEFLATE (raw, zlib and
+// gzip containers) and, when built with RPG_HAVE_ZSTD, zstd. Decompression
+// writes into a caller-provided buffer of the exact expected size so layers
+// are decoded straight into their final storage.
+class Compression {
+public:
+    enum class Container {
+        Raw,     // bare DEFLATE stream
+        Zlib,    // RFC 1950 header + Adler-32
+        Gzip     // RFC 1952 header + CRC-32/size trailer
+    };
+
+    static bool DecodeBase64(const char* text, size_t length, std::vector<unsigned char>& output);
+
+    static bool Inflate(const unsigned char* input, size_t inputSize, Container container,
+                        unsigned char* output, size_t outputSize, size_t& written);
+
+    static bool HasZstd();
+    static bool DecompressZstd(const unsigned char* input, size_t inputSize,
+                               unsigned char* output, size_t outputSize, size_t& written);
+
+private:
+    static bool InflateRaw(const unsigned char* input, size_t inputSize, size_t& consumed,
+                           unsigned char* output, size_t outputSize, size_t& written);
+};
@@ -46,4 +46,16 @@ namespace FileUtils {
 
         return candidate;
     }
+
+    // Case-insensitive check of a path's extension (".tmx", ".png"...)
+    inline bool HasExtension(const std::string& path, const std::string& extension) {
+        if (path.size() < extension.size()) return false;
+
+        size_t offset = path.size() - extension.size();
+        for (size_t i = 0; i < extension.size(); ++i) {
+            if (std::tolower((unsigned char)path[offset + i]) != std::tolower((unsigned char)extension[i]))
+                return false;
+        }
+        return true;
+    }
 }
@@ -0,0 +1,52 @@
+#include "MainThread.h"
+
+std::thread::id MainThread::s_id;
+bool MainThread::s_registered = false;
+std::mutex MainThread::s_mutex;
+std::condition_variable MainThread::s_finished;
+std::deque<MainThread::Task*> MainThread::s_pending;
+
+void MainThread::Register() {
+    s_id = std::this_thread::get_id();
+    s_registered = true;
+}
+
+bool MainThread::IsCurrent() {
+    return !s_registered || std::this_thread::get_id() == s_id;
+}
+
+void MainThread::Invoke(const std::function<void()>& task) {
+    if (IsCurrent()) {
+        task();
+        return;
+    }
+
+    Task pending;
+    pending.work = &task;
+
+    std::unique_lock<std::mutex> lock(s_mutex);
+    s_pending.push_back(&pending);
+    s_finished.wait(lock, [&] { return pending.done; });
+}
+
+// Tasks queued while these run wait for the next call
+void MainThread::ProcessPending() {
+    std::deque<Task*> tasks;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        tasks.swap(s_pending);
+    }
+    if (tasks.empty()) return;
+
+    for (Task* task : tasks) {
+        (*task->work)();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (Task* task : tasks) {
+            task->done = true;
+        }
+    }
+    s_finished.notify_all();
+}
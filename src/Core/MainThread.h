@@ -0,0 +1,35 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//==============================================================================
+// MAIN THREAD
+//==============================================================================
+// Runs work that must happen on the thread owning the OpenGL context (texture
+// uploads) on behalf of loader threads. Invoke() called from a worker queues
+// the task and blocks until the main loop has run it through
+// ProcessPending(); called from the main thread, or before Register(), it
+// runs the task immediately.
+class MainThread {
+public:
+    static void Register();
+    static bool IsCurrent();
+
+    static void Invoke(const std::function<void()>& task);
+    static void ProcessPending();
+
+private:
+    struct Task {
+        const std::function<void()>* work = nullptr;
+        bool done = false;
+    };
+
+    static std::thread::id s_id;
+    static bool s_registered;
+    static std::mutex s_mutex;
+    static std::condition_variable s_finished;
+    static std::deque<Task*> s_pending;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+//==============================================================================
+// MAPPED FILE
+//==============================================================================
+// Read-only memory mapping of a whole file (mmap / MapViewOfFile). The
+// header deliberately avoids raylib so the Windows implementation can
+// include <windows.h> without name clashes.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const unsigned char* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_descriptor = -1;
+#endif
+};
@@ -0,0 +1,69 @@
+#include "MemoryTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> s_currentBytes{0};
+    std::atomic<size_t> s_peakBytes{0};
+
+    // Each block is prefixed with its size, kept max-aligned
+    constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    void* Allocate(size_t size) {
+        void* block = std::malloc(size + HEADER_SIZE);
+        if (!block) return nullptr;
+        *static_cast<size_t*>(block) = size;
+
+        size_t current = s_currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t peak = s_peakBytes.load(std::memory_order_relaxed);
+        while (current > peak && !s_peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+        }
+        return static_cast<char*>(block) + HEADER_SIZE;
+    }
+
+    void Free(void* pointer) {
+        if (!pointer) return;
+        void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+        s_currentBytes.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+//==============================================================================
+// QUERIES
+//==============================================================================
+size_t MemoryTracker::GetCurrentBytes() {
+    return s_currentBytes.load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::GetPeakBytes() {
+    return s_peakBytes.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::ResetPeak() {
+    s_peakBytes.store(s_currentBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+//==============================================================================
+// GLOBAL OPERATOR NEW / DELETE
+//==============================================================================
+void* operator new(size_t size) {
+    if (void* pointer = Allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* pointer = Allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+
+void operator delete(void* pointer) noexcept { Free(pointer); }
+void operator delete[](void* pointer) noexcept { Free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { Free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { Free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { Free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { Free(pointer); }
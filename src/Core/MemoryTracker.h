@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+
+//==============================================================================
+// MEMORY TRACKER
+//==============================================================================
+// Counts the bytes held by the global operator new, so a load can report its
+// real heap high-water mark, transient buffers included. Aligned allocations
+// and raw malloc (raylib, stb) are not counted.
+//
+// Diagnostic only: MemoryTracker.cpp is built, and the allocator replaced,
+// only with MEMORY_TRACKING=1 (RPG_MEMORY_TRACKING).
+namespace MemoryTracker {
+    size_t GetCurrentBytes();
+    size_t GetPeakBytes();
+
+    // Starts a new measurement: the peak restarts from the current usage
+    void ResetPeak();
+}
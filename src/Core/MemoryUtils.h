@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace MemoryUtils {
+
+    // Heap bytes reserved by a vector's buffer
+    template <typename T>
+    inline size_t VectorBytes(const std::vector<T>& values) {
+        return values.capacity() * sizeof(T);
+    }
+
+    inline std::string FormatBytes(size_t bytes) {
+        char buffer[32];
+        if (bytes >= 1024 * 1024) {
+            std::snprintf(buffer, sizeof(buffer), "%.2f MB", bytes / (1024.0 * 1024.0));
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+        }
+        return buffer;
+    }
+}
@@ -1,6 +1,8 @@
 #include "ResourceManager.h"
+#include <algorithm>
 
 ResourceManager* ResourceManager::s_instance = nullptr;
+const Texture2D ResourceManager::s_emptyTexture{};
 
 ResourceManager& ResourceManager::GetInstance() {
     if (!s_instance) {
@@ -9,27 +11,214 @@ ResourceManager& ResourceManager::GetInstance() {
     return *s_instance;
 }
 
-Texture2D& ResourceManager::LoadTextureCached(const std::string& path) {
-    auto it = m_textureCache.find(path);
-    if (it != m_textureCache.end()) {
-        return it->second;
+//==============================================================================
+// SLOTS
+//==============================================================================
+TextureHandle ResourceManager::FindTexture(const std::string& name) const {
+    auto it = m_textureIndex.find(name);
+    if (it == m_textureIndex.end()) {
+        return TextureHandle{};
+    }
+    return {it->second, m_slots[it->second].generation};
+}
+
+// Réutilise un slot libéré si possible, sinon en ajoute un
+TextureHandle ResourceManager::StoreTexture(const std::string& name, Texture2D texture) {
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = (uint32_t)m_slots.size();
+        m_slots.emplace_back();
+    }
+
+    TextureSlot& slot = m_slots[index];
+    slot.texture = texture;
+    slot.name = name;
+    slot.refCount = 1;
+    slot.used = true;
+    m_textureIndex[name] = index;
+    return {index, slot.generation};
+}
+
+TextureHandle ResourceManager::Acquire(TextureHandle handle) {
+    m_slots[handle.index].refCount++;
+    return handle;
+}
+
+// Libère la texture et invalide tous les handles du slot
+size_t ResourceManager::ReleaseSlot(uint32_t index) {
+    TextureSlot& slot = m_slots[index];
+    size_t bytes = GetTextureBytes(slot.texture);
+    if (slot.texture.id != 0) {
+        ::UnloadTexture(slot.texture);
+    }
+    m_textureIndex.erase(slot.name);
+
+    slot.texture = Texture2D{};
+    slot.name.clear();
+    slot.refCount = 0;
+    slot.used = false;
+    if (++slot.generation == 0) slot.generation = 1;
+    m_freeSlots.push_back(index);
+    return bytes;
+}
+
+//==============================================================================
+// CHARGEMENT
+//==============================================================================
+TextureHandle ResourceManager::LoadTextureCached(const std::string& path) {
+    TextureHandle cached = FindTexture(path);
+    if (cached.IsValid()) {
+        return Acquire(cached);
     }
 
     Texture2D tex{};
     if (!path.empty()) {
         tex = LoadTexture(path.c_str());
     }
-    m_textureCache[path] = tex;
-    return m_textureCache[path];
+    return StoreTexture(path, tex);
+}
+
+// Variante à partir d'une image déjà décodée (ex. sur un thread de chargement) :
+// seul l'envoi au GPU a lieu ici
+TextureHandle ResourceManager::LoadTextureCached(const std::string& path, const Image& image) {
+    TextureHandle cached = FindTexture(path);
+    if (cached.IsValid()) {
+        return Acquire(cached);
+    }
+
+    Texture2D tex{};
+    if (image.data) {
+        tex = LoadTextureFromImage(image);
+    }
+    return StoreTexture(path, tex);
+}
+
+// Prend possession d'une texture créée ailleurs (ex. atlas généré au chargement).
+// Un nom déjà enregistré garde son slot, ses handles voient la nouvelle texture
+TextureHandle ResourceManager::RegisterTexture(const std::string& name, Texture2D texture) {
+    TextureHandle cached = FindTexture(name);
+    if (cached.IsValid()) {
+        Texture2D& current = m_slots[cached.index].texture;
+        if (current.id != 0) {
+            ::UnloadTexture(current);
+        }
+        current = texture;
+        return Acquire(cached);
+    }
+    return StoreTexture(name, texture);
+}
+
+// Décode les fichiers en parallèle ; une image sans données signale un échec
+std::vector<Image> ResourceManager::DecodeImages(const std::vector<std::string>& paths) {
+    std::vector<Image> images(paths.size());
+    m_decodePool.ParallelFor(paths.size(), [&](size_t i) {
+        if (!paths[i].empty()) {
+            images[i] = LoadImage(paths[i].c_str());
+        }
+    });
+    return images;
+}
+
+// Envoie au GPU les images décodées puis les libère (thread principal uniquement)
+std::vector<TextureHandle> ResourceManager::UploadImages(const std::vector<std::string>& paths,
+                                                         std::vector<Image>& images) {
+    std::vector<TextureHandle> textures(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        textures[i] = LoadTextureCached(paths[i], images[i]);
+        if (images[i].data) {
+            UnloadImage(images[i]);
+        }
+        images[i] = Image{};
+    }
+    return textures;
+}
+
+// Charge un lot de textures : seules celles absentes du cache sont décodées
+std::vector<TextureHandle> ResourceManager::LoadTexturesCached(const std::vector<std::string>& paths) {
+    std::vector<std::string> missing;
+    for (const auto& path : paths) {
+        if (m_textureIndex.find(path) == m_textureIndex.end() &&
+            std::find(missing.begin(), missing.end(), path) == missing.end()) {
+            missing.push_back(path);
+        }
+    }
+
+    std::vector<TextureHandle> uploaded;
+    if (!missing.empty()) {
+        std::vector<Image> images = DecodeImages(missing);
+        uploaded = UploadImages(missing, images);
+    }
+
+    // Une référence par chemin demandé ; celles de l'envoi sont ensuite rendues
+    std::vector<TextureHandle> textures;
+    textures.reserve(paths.size());
+    for (const auto& path : paths) {
+        textures.push_back(LoadTextureCached(path));
+    }
+    for (TextureHandle handle : uploaded) {
+        ReleaseTexture(handle);
+    }
+    return textures;
+}
+
+//==============================================================================
+// RECHARGEMENT / LIBÉRATION
+//==============================================================================
+bool ResourceManager::ReloadTexture(TextureHandle handle) {
+    if (!IsValid(handle)) {
+        return false;
+    }
+
+    TextureSlot& slot = m_slots[handle.index];
+    Texture2D tex = LoadTexture(slot.name.c_str());
+    if (tex.id == 0) {
+        return false;   // l'ancienne texture reste en place
+    }
+
+    if (slot.texture.id != 0) {
+        ::UnloadTexture(slot.texture);
+    }
+    slot.texture = tex;
+    return true;
+}
+
+size_t ResourceManager::ReleaseTexture(TextureHandle handle) {
+    if (!IsValid(handle)) {
+        return 0;
+    }
+
+    if (--m_slots[handle.index].refCount > 0) {
+        return 0;
+    }
+    return ReleaseSlot(handle.index);
 }
 
 void ResourceManager::UnloadAllTextures() {
-    for (auto& [path, texture] : m_textureCache) {
-        if (texture.id != 0) {
-            UnloadTexture(texture);
+    for (uint32_t i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].used) {
+            ReleaseSlot(i);
         }
     }
-    m_textureCache.clear();
+}
+
+//==============================================================================
+// MÉMOIRE VIDÉO
+//==============================================================================
+// Estimation : taille des pixels du niveau 0, sans les mipmaps
+size_t ResourceManager::GetTextureBytes(const Texture2D& texture) {
+    if (texture.id == 0) return 0;
+    return (size_t)GetPixelDataSize(texture.width, texture.height, texture.format);
+}
+
+size_t ResourceManager::GetVideoMemoryBytes() const {
+    size_t bytes = 0;
+    for (const auto& slot : m_slots) {
+        if (slot.used) bytes += GetTextureBytes(slot.texture);
+    }
+    return bytes;
 }
 
 void ResourceManager::Cleanup() {
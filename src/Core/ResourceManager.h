@@ -1,22 +1,82 @@
 #pragma once
 #include <raylib.h>
+#include <cstdint>
 #include <unordered_map>
 #include <string>
+#include <vector>
+
+#include "TextureHandle.h"
+#include "ThreadPool.h"
 
 // Singleton de gestion des ressources (textures)
+//
+// Les textures vivent dans un tableau de slots ; les détenteurs gardent un
+// TextureHandle et le résolvent par GetTexture(). Chaque chargement prend une
+// référence, rendue par ReleaseTexture() : la texture est libérée quand plus
+// personne ne l'utilise. Les slots ne sont modifiés que depuis le thread
+// principal.
 class ResourceManager {
 private:
-    std::unordered_map<std::string, Texture2D> m_textureCache;
+    struct TextureSlot {
+        Texture2D texture{};
+        std::string name;           // chemin du fichier ou nom enregistré
+        uint32_t generation = 1;    // incrémentée à chaque libération
+        int refCount = 0;
+        bool used = false;
+    };
+
+    std::vector<TextureSlot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::unordered_map<std::string, uint32_t> m_textureIndex;   // nom -> slot
     static ResourceManager* s_instance;
+    static const Texture2D s_emptyTexture;
+
+    // Décodage des images en parallèle (aucun appel GPU sur ces threads)
+    ThreadPool m_decodePool;
 
     ResourceManager() = default;
 
+    TextureHandle FindTexture(const std::string& name) const;
+    TextureHandle StoreTexture(const std::string& name, Texture2D texture);
+    TextureHandle Acquire(TextureHandle handle);
+    size_t ReleaseSlot(uint32_t index);
+
 public:
     static ResourceManager& GetInstance();
 
-    Texture2D& LoadTextureCached(const std::string& path);
+    TextureHandle LoadTextureCached(const std::string& path);
+    TextureHandle LoadTextureCached(const std::string& path, const Image& image);
+    TextureHandle RegisterTexture(const std::string& name, Texture2D texture);
 
+    // Chargement en deux temps : DecodeImages() peut tourner sur n'importe quel
+    // thread, UploadImages() envoie le lot au GPU depuis le thread principal
+    std::vector<Image> DecodeImages(const std::vector<std::string>& paths);
+    std::vector<TextureHandle> UploadImages(const std::vector<std::string>& paths, std::vector<Image>& images);
+    std::vector<TextureHandle> LoadTexturesCached(const std::vector<std::string>& paths);
+
+    // Un handle périmé ou vide donne une texture d'id 0
+    const Texture2D& GetTexture(TextureHandle handle) const {
+        if (handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation) {
+            return m_slots[handle.index].texture;
+        }
+        return s_emptyTexture;
+    }
+    bool IsValid(TextureHandle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+               m_slots[handle.index].used;
+    }
+    bool IsLoaded(TextureHandle handle) const { return GetTexture(handle).id != 0; }
+
+    // Recharge le fichier dans le même slot : les handles existants restent valides
+    bool ReloadTexture(TextureHandle handle);
+
+    // Rend une référence ; renvoie les octets de VRAM libérés (0 si encore utilisée)
+    size_t ReleaseTexture(TextureHandle handle);
     void UnloadAllTextures();
 
+    static size_t GetTextureBytes(const Texture2D& texture);
+    size_t GetVideoMemoryBytes() const;
+    int GetTextureCount() const { return (int)m_textureIndex.size(); }
+
     static void Cleanup();
 };
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+// Reference to a texture slot of the ResourceManager. The generation is
+// bumped whenever the slot is released, so a handle to an unloaded texture
+// resolves to an empty texture instead of dangling. Generation 0 is never
+// issued: a default-constructed handle refers to nothing.
+struct TextureHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return generation != 0; }
+
+    bool operator==(const TextureHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const TextureHandle& other) const { return !(*this == other); }
+};
@@ -0,0 +1,85 @@
+#include "ThreadPool.h"
+
+//==============================================================================
+// CONSTRUCTION
+//==============================================================================
+ThreadPool::ThreadPool(unsigned workerCount) {
+    if (workerCount == 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    m_workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+//==============================================================================
+// JOBS
+//==============================================================================
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& work) {
+    if (count == 0) return;
+
+    // Nothing to share: run inline
+    if (m_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) work(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> job(m_jobMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_work = &work;
+        m_count = count;
+        m_next = 0;
+        m_finished = 0;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    RunItems();
+
+    // Every worker takes part in every job, so the next one cannot start
+    // while a worker still reads this one
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [&] { return m_finished == m_workers.size(); });
+    m_work = nullptr;
+}
+
+void ThreadPool::RunItems() {
+    for (size_t i = m_next++; i < m_count; i = m_next++) {
+        (*m_work)(i);
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) return;
+            seen = m_generation;
+        }
+
+        RunItems();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (++m_finished == m_workers.size()) {
+            m_idle.notify_one();
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+// THREAD POOL
+//==============================================================================
+// Fixed set of worker threads for data-parallel jobs. ParallelFor() hands out
+// the indices of a job one at a time to the workers and the calling thread,
+// and returns once every index has been processed. Jobs from several callers
+// run one after the other.
+class ThreadPool {
+public:
+    // 0 picks one worker per hardware thread, minus the calling thread
+    explicit ThreadPool(unsigned workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void ParallelFor(size_t count, const std::function<void(size_t)>& work);
+
+    unsigned GetWorkerCount() const { return (unsigned)m_workers.size(); }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_jobMutex;          // serialises ParallelFor callers
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+
+    // Current job: set before m_generation is bumped, stable until every
+    // worker has reported back
+    const std::function<void(size_t)>* m_work = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next{0};
+    uint64_t m_generation = 0;
+    size_t m_finished = 0;
+    bool m_stopping = false;
+
+    void WorkerLoop();
+    void RunItems();
+};
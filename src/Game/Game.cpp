@@ -1,28 +1,329 @@
 #include "Game.h"
 
 //==============================================================================
-// INITIALISATION
+// CHARGEMENT EN ARRIÈRE-PLAN
 //==============================================================================
-void Game::Initialize(const std::string& mapPath) {
-    // Charger la carte
-    m_map = MapLoader::LoadMap(mapPath);
+// Lecture, génération des tuiles et des collisions sur un thread dédié : seuls
+// les envois de textures au GPU repassent par le thread principal
+void Game::StartLoading(const std::string& mapPath) {
+    m_mapPath = mapPath;
+    m_loading = true;
 
-    // Initialiser le joueur
-    m_player = std::make_unique<Player>(200.0f, 300.0f);
+    // Compteurs remis à zéro : un rechargement ne doit pas cumuler les précédents
+    m_loadProgress.stage = LoadStage::Idle;
+    m_loadProgress.bytesTotal = 0;
+    m_loadProgress.bytesParsed = 0;
+    m_loadProgress.layersDone = 0;
+    m_loadThread = std::thread(&Game::LoadWorld, this, mapPath);
+}
+
+void Game::LoadWorld(const std::string& mapPath) {
+    BeginLoadMeasure();
+
+    // Charger la carte : cache binaire s’il est à jour, sinon TMJ + génération
+    m_loadProgress.stage = LoadStage::Cache;
+    if (MapCache::Load(mapPath, m_map, m_backgroundTiles, m_objectTiles, m_objectIndex, m_collisions)) {
+        EndLoadStage("Map cache");
+    } else {
+        bool loaded = MapLoader::LoadMap(mapPath, m_map, &m_loadProgress);
+        EndLoadStage("Map");
+
+        // Carte illisible : monde vide, rien à générer ni à mettre en cache.
+        // Carte infinie : tuiles et collisions générées au fil du streaming
+        if (!loaded) {
+            std::cerr << "Error: Unable to load map " << mapPath << std::endl;
+        } else if (!m_map.infinite) {
+            BuildWorld(m_backgroundTiles, m_objectTiles, m_objectIndex, m_collisions, &m_loadProgress);
+            MapCache::Save(mapPath, m_map, m_backgroundTiles, m_objectTiles, m_objectIndex, m_collisions);
+            EndLoadStage("Cache write");
+        }
+    }
+
+    EndLoadMeasure();
+    m_loadProgress.stage = LoadStage::Done;
+}
+
+//------------------------------------------------------------------------------
+// Pic du tas (tampons temporaires compris) étape par étape : une copie
+// transitoire apparaît dans l’étape qui la fait, même si une autre étape
+// monte plus haut. Sans MEMORY_TRACKING, rien n’est mesuré.
+void Game::BeginLoadMeasure() {
+#ifdef RPG_MEMORY_TRACKING
+    m_loadPeaks.clear();
+    m_loadPeakBytes = 0;
+    MemoryTracker::ResetPeak();
+    m_loadStartBytes = m_stageStartBytes = MemoryTracker::GetCurrentBytes();
+#endif
+}
+
+void Game::EndLoadStage(const char* stage) {
+#ifdef RPG_MEMORY_TRACKING
+    size_t peak = MemoryTracker::GetPeakBytes();
+    m_loadPeaks.push_back({stage, peak - m_stageStartBytes});
+    m_loadPeakBytes = std::max(m_loadPeakBytes, peak - m_loadStartBytes);
+
+    MemoryTracker::ResetPeak();
+    m_stageStartBytes = MemoryTracker::GetCurrentBytes();
+#else
+    (void)stage;
+#endif
+}
+
+void Game::EndLoadMeasure() {
+#ifdef RPG_MEMORY_TRACKING
+    size_t endBytes = MemoryTracker::GetCurrentBytes();
+    m_loadRetainedBytes = endBytes > m_loadStartBytes ? endBytes - m_loadStartBytes : 0;
+#endif
+}
+
+void Game::UpdateLoading() {
+    // Exécuter les envois GPU demandés par le thread de chargement
+    MainThread::ProcessPending();
+
+    if (m_loadProgress.stage == LoadStage::Done) {
+        FinishLoading();
+        return;
+    }
+    DrawLoadingScreen();
+}
+
+//==============================================================================
+// FIN DU CHARGEMENT (thread principal)
+//==============================================================================
+void Game::FinishLoading() {
+    m_loadThread.join();
+    m_loading = false;
+
+    m_backgroundCache.SetGrid(&m_backgroundTiles);
+
+    // Initialiser le joueur (conservé d’une carte à l’autre)
+    if (!m_player) {
+        m_player = std::make_unique<Player>(200.0f, 300.0f);
+        m_playerSprite = m_depthSorter.AddSprite();
+    }
+
+    // Caméra : limitée à la carte, centrée sur le joueur
+    m_camera.SetBounds(MapLoader::GetWorldBounds(m_map));
+    m_camera.CenterOn(m_player->GetCenter());
 
+    // Carte infinie : première région chargée tout de suite, le joueur ne
+    // doit pas démarrer sans collisions
+    if (m_chunkStreamer.NeedsRegion(m_map, m_camera.GetViewRect())) {
+        StreamRegion(m_camera.GetViewRect());
+        ApplyStreamedRegion();
+    }
+
+    ReportMemory();
+}
+
+//==============================================================================
+// CHANGEMENT DE CARTE
+//==============================================================================
+// Libère la carte courante avant de charger la suivante : seules les textures
+// qu’elle était la dernière à utiliser quittent la mémoire vidéo
+void Game::ChangeMap(const std::string& mapPath) {
+    if (m_loading) return;
+
+    UnloadWorld();
+    StartLoading(mapPath);
+}
+
+void Game::UnloadWorld() {
+    StopStreaming();
+    m_backgroundCache.SetGrid(nullptr);
+    m_chunkStreamer.Reset();
+
+    m_backgroundTiles = TileGrid{};
+    m_objectTiles.clear();
+    m_objectIndex = SpriteIndex{};
+    m_collisions = CollisionWorld{};
+
+    MapLoader::UnloadMap(m_map);
+}
+
+//==============================================================================
+// ÉCRAN DE CHARGEMENT
+//==============================================================================
+static const char* GetStageName(LoadStage stage) {
+    switch (stage) {
+        case LoadStage::Cache:      return "Reading map cache";
+        case LoadStage::Parsing:    return "Parsing map";
+        case LoadStage::Textures:   return "Loading textures";
+        case LoadStage::Tiles:      return "Generating tiles";
+        case LoadStage::Collisions: return "Baking collisions";
+        case LoadStage::Done:       return "Done";
+        default:                    return "Starting";
+    }
+}
+
+void Game::DrawLoadingScreen() {
+    LoadStage stage = m_loadProgress.stage;
+    size_t bytesTotal = m_loadProgress.bytesTotal;
+    size_t bytesParsed = m_loadProgress.bytesParsed;
+
+    // Avancement global : la lecture domine, les étapes suivantes se partagent le reste
+    float fraction = 0.0f;
+    switch (stage) {
+        case LoadStage::Parsing:
+            fraction = bytesTotal > 0 ? 0.6f * (float)bytesParsed / (float)bytesTotal : 0.0f;
+            break;
+        case LoadStage::Textures:   fraction = 0.6f; break;
+        case LoadStage::Tiles:      fraction = 0.75f; break;
+        case LoadStage::Collisions: fraction = 0.85f; break;
+        case LoadStage::Done:       fraction = 1.0f; break;
+        default: break;
+    }
+
+    const int barWidth = WINDOW_WIDTH / 2;
+    const int barX = (WINDOW_WIDTH - barWidth) / 2;
+    const int barY = WINDOW_HEIGHT / 2;
+
+    BeginDrawing();
+    ClearBackground(RAYWHITE);
+    DrawText("Loading map...", barX, barY - 40, 20, DARKGRAY);
+    DrawRectangle(barX, barY, (int)(barWidth * fraction), 20, DARKGRAY);
+    DrawRectangleLines(barX, barY, barWidth, 20, DARKGRAY);
+    DrawText(GetStageName(stage), barX, barY + 30, 16, DARKGRAY);
+    DrawText(TextFormat("Parsed: %s / %s | Layers: %i",
+                        MemoryUtils::FormatBytes(bytesParsed).c_str(),
+                        MemoryUtils::FormatBytes(bytesTotal).c_str(),
+                        m_loadProgress.layersDone.load()), barX, barY + 50, 16, DARKGRAY);
+    EndDrawing();
+}
+
+//==============================================================================
+// CONSTRUCTION DU MONDE
+//==============================================================================
+// Tuiles et collisions des couches chargées (toute la carte, ou la région
+// streamée d’une carte infinie). La progression n’est suivie que pendant le
+// chargement : le streaming construit sans elle, dans le monde en attente.
+void Game::BuildWorld(TileGrid& backgroundTiles, std::vector<Tile>& objectTiles, SpriteIndex& objectIndex,
+                      CollisionWorld& collisions, LoadProgress* progress) {
     // Générer les tuiles
-    m_backgroundTiles = TileGenerator::GenerateTiles(m_map.backgroundLayers, m_map);
-    m_objectTiles = TileGenerator::GenerateTiles(m_map.otherLayers, m_map);
+    if (progress) progress->stage = LoadStage::Tiles;
+    backgroundTiles = TileGenerator::GenerateTileGrid(MapLoader::GetLayers(m_map, LayerGroup::Background), m_map);
+    objectTiles = TileGenerator::GenerateTiles(MapLoader::GetLayers(m_map, LayerGroup::Objects), m_map);
 
     // Trier les tuiles par profondeur (Y)
-    std::sort(m_objectTiles.begin(), m_objectTiles.end(),
+    std::sort(objectTiles.begin(), objectTiles.end(),
         [](const Tile& a, const Tile& b) {
             return a.sortingY < b.sortingY;
         }
     );
+    objectIndex = TileGenerator::BuildSpriteIndex(objectTiles, m_map);
+    if (progress) EndLoadStage("Tiles");
 
     // Générer les collisions
-    m_collisions = CollisionSystem::GenerateCollisions(m_map);
+    if (progress) progress->stage = LoadStage::Collisions;
+    collisions = CollisionSystem::GenerateCollisions(m_map);
+    if (progress) EndLoadStage("Collisions");
+}
+
+//==============================================================================
+// STREAMING DES CHUNKS
+//==============================================================================
+// Le thread de streaming est le seul à toucher aux couches de la carte tant
+// qu’il tourne ; le monde affiché reste celui de la région précédente
+void Game::StreamChunks() {
+    if (m_streaming) {
+        if (!m_streamDone) return;
+        m_streamThread.join();
+        m_streaming = false;
+        ApplyStreamedRegion();
+    }
+
+    const Rectangle view = m_camera.GetViewRect();
+    if (!m_chunkStreamer.NeedsRegion(m_map, view)) return;
+
+    m_streaming = true;
+    m_streamDone = false;
+    m_streamThread = std::thread(&Game::StreamRegion, this, view);
+}
+
+void Game::StreamRegion(Rectangle view) {
+    m_chunkStreamer.LoadRegion(m_map, view);
+    BuildWorld(m_streamBackgroundTiles, m_streamObjectTiles, m_streamObjectIndex, m_streamCollisions);
+    m_streamDone = true;
+}
+
+// Les chunks d’arrière-plan que les deux régions couvrent restent en cache
+void Game::ApplyStreamedRegion() {
+    std::swap(m_backgroundTiles, m_streamBackgroundTiles);
+    std::swap(m_objectTiles, m_streamObjectTiles);
+    std::swap(m_objectIndex, m_streamObjectIndex);
+    std::swap(m_collisions, m_streamCollisions);
+    m_backgroundCache.SetGrid(&m_backgroundTiles);
+
+    // L’ancien monde n’est plus affiché
+    m_streamBackgroundTiles = TileGrid{};
+    m_streamObjectTiles.clear();
+    m_streamObjectIndex = SpriteIndex{};
+    m_streamCollisions = CollisionWorld{};
+}
+
+void Game::StopStreaming() {
+    if (m_streamThread.joinable()) {
+        m_streamThread.join();
+    }
+    m_streaming = false;
+}
+
+//==============================================================================
+// RAPPORT MÉMOIRE
+//==============================================================================
+// Seulement avec MEMORY_TRACKING=1, avec le pic du tas mesuré au chargement
+void Game::ReportMemory() const {
+#ifdef RPG_MEMORY_TRACKING
+    using MemoryUtils::VectorBytes;
+
+    size_t layerBytes = VectorBytes(m_map.layers);
+    size_t chunkBytes = 0;
+    for (const auto& layer : m_map.layers) {
+        layerBytes += VectorBytes(layer.data);
+        for (const auto& [key, chunk] : layer.chunks) {
+            chunkBytes += sizeof(chunk) + chunk.encoded.capacity() + VectorBytes(chunk.packed) +
+                          VectorBytes(chunk.data);
+        }
+    }
+
+    size_t tileBytes = VectorBytes(m_backgroundTiles.tiles) + VectorBytes(m_backgroundTiles.cellStart) +
+                       VectorBytes(m_objectTiles) + VectorBytes(m_objectIndex.cellStart) +
+                       VectorBytes(m_objectIndex.cellItems);
+
+    const CollisionStore& store = m_collisions.store;
+    size_t storeBytes = VectorBytes(store.minX) + VectorBytes(store.minY) +
+                        VectorBytes(store.maxX) + VectorBytes(store.maxY) +
+                        VectorBytes(store.kind) + VectorBytes(store.invRadiusX) +
+                        VectorBytes(store.invRadiusY) + VectorBytes(store.firstPoint) +
+                        VectorBytes(store.pointCount) + VectorBytes(store.points) +
+                        VectorBytes(store.edgeNormals) + VectorBytes(store.projMin) +
+                        VectorBytes(store.projMax);
+
+    const CollisionGrid& grid = m_collisions.grid;
+    size_t gridBytes = VectorBytes(grid.cellStart) + VectorBytes(grid.cellItems) +
+                       VectorBytes(grid.itemMinX) + VectorBytes(grid.itemMinY) +
+                       VectorBytes(grid.itemMaxX) + VectorBytes(grid.itemMaxY);
+
+    std::cout << "Memory after load:" << std::endl;
+    std::cout << "  Layer data:      " << MemoryUtils::FormatBytes(layerBytes) << std::endl;
+    if (m_map.infinite) {
+        std::cout << "  Chunk table:     " << MemoryUtils::FormatBytes(chunkBytes) << std::endl;
+    }
+    std::cout << "  Tiles:           " << MemoryUtils::FormatBytes(tileBytes) << std::endl;
+    std::cout << "  Collision store: " << MemoryUtils::FormatBytes(storeBytes) << std::endl;
+    std::cout << "  Collision grid:  " << MemoryUtils::FormatBytes(gridBytes) << std::endl;
+    std::cout << "  Load heap peak:  " << MemoryUtils::FormatBytes(m_loadPeakBytes) << " ("
+              << MemoryUtils::FormatBytes(m_loadRetainedBytes) << " retained)" << std::endl;
+    for (const auto& peak : m_loadPeaks) {
+        std::string label = std::string(peak.stage) + ":";
+        label.resize(std::max<size_t>(label.size(), 15), ' ');
+        std::cout << "    " << label << "+" << MemoryUtils::FormatBytes(peak.bytes) << std::endl;
+    }
+
+    const ResourceManager& resourceMgr = ResourceManager::GetInstance();
+    std::cout << "  Textures:        " << resourceMgr.GetTextureCount() << " ("
+              << MemoryUtils::FormatBytes(resourceMgr.GetVideoMemoryBytes()) << " VRAM)" << std::endl;
+#endif
 }
 
 //==============================================================================
@@ -34,8 +335,27 @@ void Game::Update() {
         m_debugMode = !m_debugMode;
     }
 
+    // Recharger la carte courante (transition de niveau)
+    if (IsKeyPressed(KEY_F5)) {
+        ChangeMap(m_mapPath);
+        return;
+    }
+
     // Mettre à jour le joueur
     m_player->Update(m_collisions);
+
+    // Entités dynamiques : sprite courant puis tri incrémental par profondeur
+    DynamicSprite sprite;
+    m_player->GetSprite(sprite);
+    m_depthSorter.SetSprite(m_playerSprite, sprite);
+    m_depthSorter.Sort();
+
+    // Mettre à jour la caméra
+    m_camera.HandleInput();
+    m_camera.Follow(m_player->GetCenter());
+
+    // Carte infinie : suivre la caméra
+    StreamChunks();
 }
 
 //==============================================================================
@@ -44,17 +364,33 @@ void Game::Update() {
 void Game::Render() {
     BeginDrawing();
     ClearBackground(RAYWHITE);
+    RenderSystem::ResetStats();
 
-    // Dessiner les tuiles d’arrière-plan
-    RenderSystem::DrawTiles(m_backgroundTiles);
+    const Rectangle view = m_camera.GetViewRect();
 
-    // Dessiner les objets et le joueur avec tri Y
-    RenderSystem::DrawTilesWithPlayer(m_objectTiles, *m_player);
+    // Pré-rendre les chunks d’arrière-plan manquants (hors mode caméra)
+    m_backgroundCache.Prepare(view);
 
-    // Mode debug
+    // Monde (coordonnées caméra)
+    m_camera.Begin();
+
+    // Dessiner les chunks d’arrière-plan visibles
+    m_backgroundCache.Draw(view);
+
+    // Dessiner les objets visibles et les entités avec tri Y, regroupés par texture
+    RenderSystem::SubmitTilesWithSprites(m_renderQueue, m_objectTiles, m_objectIndex, view, m_depthSorter);
+    m_renderQueue.Flush();
+
+    // Mode debug (monde)
     if (m_debugMode) {
-        RenderSystem::DrawCollisionDebug(m_collisions);
+        RenderSystem::DrawCollisionDebug(m_collisions, view);
         m_player->DrawDebug();
+    }
+
+    m_camera.End();
+
+    // Mode debug (écran)
+    if (m_debugMode) {
         DrawDebugText();
     }
 
@@ -65,10 +401,19 @@ void Game::Render() {
 // TEXTE DEBUG
 //==============================================================================
 void Game::DrawDebugText() {
-    DrawText("Debug Mode (F1 to toggle)", 10, 10, 16, DARKGRAY);
+    DrawText("Debug Mode (F1 to toggle, F5 to reload map)", 10, 10, 16, DARKGRAY);
     DrawText("Rect=Red | Ellipse=Orange | Poly=Blue | Polyline=Purple", 10, 30, 16, DARKGRAY);
-    DrawText("Use Arrow Keys to move, Space to attack", 10, 50, 16, DARKGRAY);
+    DrawText("Use Arrow Keys to move, Space to attack, Mouse Wheel to zoom", 10, 50, 16, DARKGRAY);
     DrawFPS(10, 70);
+    DrawText(TextFormat("Tiles drawn: %i | Zoom: %.1fx", RenderSystem::GetTilesDrawn(), m_camera.GetZoom()), 10, 90, 16, DARKGRAY);
+    DrawText(TextFormat("Background chunks: %i (%s)", m_backgroundCache.GetChunkCount(),
+                        MemoryUtils::FormatBytes(m_backgroundCache.GetMemoryBytes()).c_str()), 10, 110, 16, DARKGRAY);
+    DrawText(TextFormat("Texture switches: %i (unbatched: %i) | Sprites: %i", m_renderQueue.GetTextureSwitches(),
+                        m_renderQueue.GetUnbatchedSwitches(), m_renderQueue.GetCommandCount()), 10, 130, 16, DARKGRAY);
+    if (m_map.infinite) {
+        DrawText(TextFormat("Streamed chunks: %i (decoded: %i)", m_chunkStreamer.GetRegionChunkCount(),
+                            m_chunkStreamer.GetDecodedChunkCount()), 10, 150, 16, DARKGRAY);
+    }
 }
 
 //==============================================================================
@@ -79,12 +424,18 @@ void Game::Run(const std::string& mapPath) {
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE);
     SetTargetFPS(TARGET_FPS);
 
-    // Initialiser le jeu
-    Initialize(mapPath);
+    // Charger la carte en arrière-plan, écran de chargement en attendant
+    MainThread::Register();
+    StartLoading(mapPath);
 
     // Boucle principale
     while (!WindowShouldClose()) {
+        if (m_loading) {
+            UpdateLoading();
+            continue;
+        }
         Update();
+        if (m_loading) continue;   // changement de carte demandé
         Render();
     }
 
@@ -96,6 +447,18 @@ void Game::Run(const std::string& mapPath) {
 // LIBÉRATION DES RESSOURCES
 //==============================================================================
 void Game::Cleanup() {
+    // Fenêtre fermée pendant le chargement : le thread peut attendre un envoi GPU
+    if (m_loadThread.joinable()) {
+        while (m_loadProgress.stage != LoadStage::Done) {
+            MainThread::ProcessPending();
+            std::this_thread::yield();
+        }
+        m_loadThread.join();
+    }
+
+    // Rendre les références avant de libérer le gestionnaire
+    m_player.reset();
+    UnloadWorld();
     ResourceManager::Cleanup();
     CloseWindow();
 }
@@ -1,17 +1,30 @@
 #pragma once
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <algorithm>
 #include <raylib.h>
 
 #include "../Map/TMJTypes.h"
 #include "../Map/MapLoader.h"
+#include "../Map/MapCache.h"
+#include "../Map/ChunkStreamer.h"
 #include "../Map/TileGenerator.h"
 #include "../Map/CollisionSystem.h"
 #include "../Render/RenderSystem.h"
+#include "../Render/CameraSystem.h"
+#include "../Render/BackgroundCache.h"
+#include "../Render/RenderQueue.h"
+#include "../Render/DepthSorter.h"
 #include "../Player/Player.h"
 #include "../Core/ResourceManager.h"
+#include "../Core/MainThread.h"
+#include "../Core/MemoryUtils.h"
+#ifdef RPG_MEMORY_TRACKING
+#include "../Core/MemoryTracker.h"
+#endif
 
 // Classe principale du jeu (boucle, initialisation, rendu)
 class Game {
@@ -22,21 +35,73 @@ private:
     static constexpr const char* WINDOW_TITLE = "Raylib - TMJ Game Engine";
 
     TMJMap m_map;
+    std::string m_mapPath;
+    ChunkStreamer m_chunkStreamer;
     std::unique_ptr<Player> m_player;
-    std::vector<Tile> m_backgroundTiles;
+    CameraSystem m_camera{WINDOW_WIDTH, WINDOW_HEIGHT};
+    TileGrid m_backgroundTiles;
+    BackgroundCache m_backgroundCache;
     std::vector<Tile> m_objectTiles;
-    std::vector<PositionedCollision> m_collisions;
+    SpriteIndex m_objectIndex;
+    RenderQueue m_renderQueue;
+    DepthSorter m_depthSorter;
+    int m_playerSprite = -1;
+    CollisionWorld m_collisions;
     bool m_debugMode = true;
 
-    void Initialize(const std::string& mapPath);
+    // Chargement en arrière-plan
+    std::thread m_loadThread;
+    LoadProgress m_loadProgress;
+    bool m_loading = false;
+
+    // Streaming d’une carte infinie : la région suivante et son monde sont
+    // construits sur un thread dédié, puis échangés avec le monde affiché
+    std::thread m_streamThread;
+    std::atomic<bool> m_streamDone{false};
+    bool m_streaming = false;
+    TileGrid m_streamBackgroundTiles;
+    std::vector<Tile> m_streamObjectTiles;
+    SpriteIndex m_streamObjectIndex;
+    CollisionWorld m_streamCollisions;
+
+    // Tas mesuré pendant le chargement (MEMORY_TRACKING=1) : pic de chaque
+    // étape au-dessus de l’utilisation à son début, pic global et part
+    // conservée à la fin
+    struct LoadPeak {
+        const char* stage;
+        size_t bytes;
+    };
+    std::vector<LoadPeak> m_loadPeaks;
+    size_t m_loadStartBytes = 0;
+    size_t m_stageStartBytes = 0;
+    size_t m_loadPeakBytes = 0;
+    size_t m_loadRetainedBytes = 0;
+
+    void StartLoading(const std::string& mapPath);
+    void UnloadWorld();
+    void LoadWorld(const std::string& mapPath);
+    void BeginLoadMeasure();
+    void EndLoadStage(const char* stage);
+    void EndLoadMeasure();
+    void UpdateLoading();
+    void FinishLoading();
+    void DrawLoadingScreen();
+    void BuildWorld(TileGrid& backgroundTiles, std::vector<Tile>& objectTiles, SpriteIndex& objectIndex,
+                    CollisionWorld& collisions, LoadProgress* progress = nullptr);
+    void StreamChunks();
+    void StreamRegion(Rectangle view);
+    void ApplyStreamedRegion();
+    void StopStreaming();
     void Update();
     void Render();
     void DrawDebugText();
+    void ReportMemory() const;
 
 public:
     Game() = default;
     ~Game() = default;
 
     void Run(const std::string& mapPath);
+    void ChangeMap(const std::string& mapPath);
     void Cleanup();
 };
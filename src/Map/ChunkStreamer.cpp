@@ -0,0 +1,143 @@
+#include "ChunkStreamer.h"
+#include "MapLoader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+// UPDATE
+//==============================================================================
+// Stay on the current region while it still covers the view plus its keep margin
+bool ChunkStreamer::NeedsRegion(const TMJMap& map, const Rectangle& view) const {
+    if (!map.infinite || map.chunkWidth <= 0 || map.chunkHeight <= 0) return false;
+    return !m_hasRegion || !Contains(m_region, GetViewRegion(map, view, KEEP_MARGIN));
+}
+
+void ChunkStreamer::LoadRegion(TMJMap& map, const Rectangle& view) {
+    if (!map.infinite || map.chunkWidth <= 0 || map.chunkHeight <= 0) return;
+
+    Region region = GetViewRegion(map, view, LOAD_MARGIN);
+    FillRegion(map, region);
+    if (m_hasRegion) {
+        ReleaseOutside(map, m_region, region);
+    }
+
+    m_region = region;
+    m_hasRegion = true;
+    m_regionChunks = region.width * region.height;
+}
+
+void ChunkStreamer::Reset() {
+    m_region = Region{};
+    m_hasRegion = false;
+    m_regionChunks = 0;
+    m_decodedChunks = 0;
+}
+
+//==============================================================================
+// REGIONS
+//==============================================================================
+ChunkStreamer::Region ChunkStreamer::GetViewRegion(const TMJMap& map, const Rectangle& view, int margin) {
+    float chunkWidth = (float)(map.chunkWidth * map.tileWidth);
+    float chunkHeight = (float)(map.chunkHeight * map.tileHeight);
+
+    Region region;
+    region.x = (int)std::floor(view.x / chunkWidth) - margin;
+    region.y = (int)std::floor(view.y / chunkHeight) - margin;
+    region.width = (int)std::floor((view.x + view.width) / chunkWidth) + margin - region.x + 1;
+    region.height = (int)std::floor((view.y + view.height) / chunkHeight) + margin - region.y + 1;
+    return region;
+}
+
+bool ChunkStreamer::Contains(const Region& outer, const Region& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+bool ChunkStreamer::Contains(const Region& region, int chunkX, int chunkY) {
+    return chunkX >= region.x && chunkX < region.x + region.width &&
+           chunkY >= region.y && chunkY < region.y + region.height;
+}
+
+//==============================================================================
+// FILL REGION
+//==============================================================================
+// Rewrites every layer as a dense grid of the region's tiles, copying each
+// chunk present in the table row by row
+void ChunkStreamer::FillRegion(TMJMap& map, const Region& region) {
+    map.originX = region.x * map.chunkWidth;
+    map.originY = region.y * map.chunkHeight;
+    map.width = region.width * map.chunkWidth;
+    map.height = region.height * map.chunkHeight;
+
+    for (auto& layer : map.layers) {
+        layer.width = map.width;
+        layer.height = map.height;
+        layer.data.assign((size_t)map.width * map.height, 0);
+        if (layer.chunks.empty()) continue;
+
+        for (int cy = region.y; cy < region.y + region.height; ++cy) {
+            for (int cx = region.x; cx < region.x + region.width; ++cx) {
+                auto it = layer.chunks.find(MapLoader::GetChunkKey(cx, cy));
+                if (it == layer.chunks.end()) continue;
+
+                LayerChunk& chunk = it->second;
+                if (chunk.data.empty() && !DecodeChunk(chunk, layer.compression)) continue;
+
+                size_t tileCount = (size_t)chunk.width * chunk.height;
+                if (chunk.data.size() < tileCount) continue;
+
+                int left = chunk.x - map.originX;
+                int top = chunk.y - map.originY;
+                for (int row = 0; row < chunk.height; ++row) {
+                    std::memcpy(&layer.data[(size_t)(top + row) * map.width + left],
+                                &chunk.data[(size_t)row * chunk.width],
+                                (size_t)chunk.width * sizeof(int));
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+// RELEASE
+//==============================================================================
+// Chunks of the previous region that the new one no longer covers drop their
+// decoded tiles; their encoded or packed form stays in the table
+void ChunkStreamer::ReleaseOutside(TMJMap& map, const Region& previous, const Region& region) {
+    for (auto& layer : map.layers) {
+        if (layer.chunks.empty()) continue;
+
+        for (int cy = previous.y; cy < previous.y + previous.height; ++cy) {
+            for (int cx = previous.x; cx < previous.x + previous.width; ++cx) {
+                if (Contains(region, cx, cy)) continue;
+
+                auto it = layer.chunks.find(MapLoader::GetChunkKey(cx, cy));
+                if (it == layer.chunks.end() || it->second.data.empty()) continue;
+
+                std::vector<int>().swap(it->second.data);
+                m_decodedChunks--;
+            }
+        }
+    }
+}
+
+bool ChunkStreamer::DecodeChunk(LayerChunk& chunk, const std::string& compression) {
+    if (chunk.encoded.empty() && chunk.packed.empty()) return false;
+
+    size_t tileCount = (size_t)chunk.width * chunk.height;
+    bool decoded = chunk.encoded.empty()
+        ? MapLoader::UnpackChunkData(chunk.packed, tileCount, chunk.data)
+        : MapLoader::DecodeLayerData(chunk.encoded.data(), chunk.encoded.size(), compression, tileCount, chunk.data);
+    if (!decoded) {
+        std::cerr << "Warning: Chunk at " << chunk.x << "," << chunk.y << " could not be decoded" << std::endl;
+        chunk.encoded.clear();
+        chunk.packed.clear();
+        std::vector<int>().swap(chunk.data);
+        return false;
+    }
+
+    m_decodedChunks++;
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <raylib.h>
+
+#include "TMJTypes.h"
+
+//==============================================================================
+// CHUNK STREAMER
+//==============================================================================
+// Keeps the layers of an infinite map filled for a region of whole chunks
+// around the camera: the view plus LOAD_MARGIN chunks on each side. The
+// region only moves once the view comes within KEEP_MARGIN chunks of its
+// edge, so walking across a chunk border does not rebuild the world every
+// frame.
+//
+// NeedsRegion() is the cheap per-frame check. LoadRegion() then rewrites
+// every layer's data to the new region from the sparse chunk table: chunks
+// entering it are decoded, chunks leaving it release their decoded data. It
+// may run on a worker thread while nothing else touches the map's layers; the
+// caller regenerates tiles and collisions afterwards, which drops those of
+// far chunks.
+class ChunkStreamer {
+public:
+    static constexpr int LOAD_MARGIN = 2;
+    static constexpr int KEEP_MARGIN = 1;
+
+    bool NeedsRegion(const TMJMap& map, const Rectangle& view) const;
+    void LoadRegion(TMJMap& map, const Rectangle& view);
+    void Reset();
+
+    // Safe to read while LoadRegion() runs on another thread
+    int GetRegionChunkCount() const { return m_regionChunks; }
+    int GetDecodedChunkCount() const { return m_decodedChunks; }
+
+private:
+    // Chunk coordinates
+    struct Region {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    Region m_region;
+    bool m_hasRegion = false;
+    std::atomic<int> m_regionChunks{0};
+    std::atomic<int> m_decodedChunks{0};
+
+    static Region GetViewRegion(const TMJMap& map, const Rectangle& view, int margin);
+    static bool Contains(const Region& outer, const Region& inner);
+    static bool Contains(const Region& region, int chunkX, int chunkY);
+
+    void FillRegion(TMJMap& map, const Region& region);
+    void ReleaseOutside(TMJMap& map, const Region& previous, const Region& region);
+    bool DecodeChunk(LayerChunk& chunk, const std::string& compression);
+};
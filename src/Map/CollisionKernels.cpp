@@ -0,0 +1,159 @@
+#include "CollisionKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define COLLISION_KERNELS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define KERNEL_TARGET(isa)
+#endif
+
+//==============================================================================
+// SCALAR
+//==============================================================================
+static uint32_t OverlapMaskScalar(const Rectangle& query,
+                                  const float* minX, const float* minY,
+                                  const float* maxX, const float* maxY,
+                                  int count) {
+    const float qMinX = query.x;
+    const float qMinY = query.y;
+    const float qMaxX = query.x + query.width;
+    const float qMaxY = query.y + query.height;
+
+    uint32_t mask = 0;
+    for (int i = 0; i < count; ++i) {
+        bool hit = (qMinX < maxX[i]) & (qMaxX > minX[i]) &
+                   (qMinY < maxY[i]) & (qMaxY > minY[i]);
+        mask |= (uint32_t)hit << i;
+    }
+    return mask;
+}
+
+#ifdef COLLISION_KERNELS_X86
+//==============================================================================
+// SSE2 (4 boxes per step)
+//==============================================================================
+KERNEL_TARGET("sse2")
+static uint32_t OverlapMaskSSE2(const Rectangle& query,
+                                const float* minX, const float* minY,
+                                const float* maxX, const float* maxY,
+                                int count) {
+    const __m128 qMinX = _mm_set1_ps(query.x);
+    const __m128 qMinY = _mm_set1_ps(query.y);
+    const __m128 qMaxX = _mm_set1_ps(query.x + query.width);
+    const __m128 qMaxY = _mm_set1_ps(query.y + query.height);
+
+    uint32_t mask = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 hitX = _mm_and_ps(_mm_cmplt_ps(qMinX, _mm_loadu_ps(maxX + i)),
+                                 _mm_cmpgt_ps(qMaxX, _mm_loadu_ps(minX + i)));
+        __m128 hitY = _mm_and_ps(_mm_cmplt_ps(qMinY, _mm_loadu_ps(maxY + i)),
+                                 _mm_cmpgt_ps(qMaxY, _mm_loadu_ps(minY + i)));
+        mask |= (uint32_t)_mm_movemask_ps(_mm_and_ps(hitX, hitY)) << i;
+    }
+    if (i < count) {
+        mask |= OverlapMaskScalar(query, minX + i, minY + i, maxX + i, maxY + i, count - i) << i;
+    }
+    return mask;
+}
+
+//==============================================================================
+// AVX2 (8 boxes per step)
+//==============================================================================
+KERNEL_TARGET("avx2")
+static uint32_t OverlapMaskAVX2(const Rectangle& query,
+                                const float* minX, const float* minY,
+                                const float* maxX, const float* maxY,
+                                int count) {
+    const __m256 qMinX = _mm256_set1_ps(query.x);
+    const __m256 qMinY = _mm256_set1_ps(query.y);
+    const __m256 qMaxX = _mm256_set1_ps(query.x + query.width);
+    const __m256 qMaxY = _mm256_set1_ps(query.y + query.height);
+
+    uint32_t mask = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 hitX = _mm256_and_ps(_mm256_cmp_ps(qMinX, _mm256_loadu_ps(maxX + i), _CMP_LT_OQ),
+                                    _mm256_cmp_ps(qMaxX, _mm256_loadu_ps(minX + i), _CMP_GT_OQ));
+        __m256 hitY = _mm256_and_ps(_mm256_cmp_ps(qMinY, _mm256_loadu_ps(maxY + i), _CMP_LT_OQ),
+                                    _mm256_cmp_ps(qMaxY, _mm256_loadu_ps(minY + i), _CMP_GT_OQ));
+        mask |= (uint32_t)_mm256_movemask_ps(_mm256_and_ps(hitX, hitY)) << i;
+    }
+    if (i < count) {
+        // Masked tail rather than a call to the SSE2 kernel: legacy SSE code
+        // running with dirty upper lanes pays an AVX/SSE transition, which
+        // dominated the small per-query batches
+        int remaining = count - i;
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i active = _mm256_cmpgt_epi32(_mm256_set1_epi32(remaining), lanes);
+        __m256 hitX = _mm256_and_ps(_mm256_cmp_ps(qMinX, _mm256_maskload_ps(maxX + i, active), _CMP_LT_OQ),
+                                    _mm256_cmp_ps(qMaxX, _mm256_maskload_ps(minX + i, active), _CMP_GT_OQ));
+        __m256 hitY = _mm256_and_ps(_mm256_cmp_ps(qMinY, _mm256_maskload_ps(maxY + i, active), _CMP_LT_OQ),
+                                    _mm256_cmp_ps(qMaxY, _mm256_maskload_ps(minY + i, active), _CMP_GT_OQ));
+        uint32_t tail = (uint32_t)_mm256_movemask_ps(_mm256_and_ps(hitX, hitY)) & ((1u << remaining) - 1);
+        mask |= tail << i;
+    }
+    return mask;
+}
+#endif
+
+//==============================================================================
+// DISPATCH
+//==============================================================================
+CollisionKernels::Level CollisionKernels::DetectLevel() {
+#if defined(COLLISION_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Level::SSE2;
+#elif defined(COLLISION_KERNELS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) return Level::AVX2;
+    }
+    if (sse2) return Level::SSE2;
+#endif
+    return Level::Scalar;
+}
+
+CollisionKernels::Level CollisionKernels::s_activeLevel = CollisionKernels::DetectLevel();
+CollisionKernels::OverlapFn CollisionKernels::s_overlap = CollisionKernels::GetKernel(CollisionKernels::s_activeLevel);
+
+CollisionKernels::Level CollisionKernels::GetActiveLevel() {
+    return s_activeLevel;
+}
+
+const char* CollisionKernels::GetLevelName(Level level) {
+    switch (level) {
+        case Level::AVX2: return "AVX2";
+        case Level::SSE2: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+CollisionKernels::OverlapFn CollisionKernels::GetKernel(Level level) {
+    if (level > s_activeLevel) return nullptr;
+
+    switch (level) {
+#ifdef COLLISION_KERNELS_X86
+        case Level::AVX2: return OverlapMaskAVX2;
+        case Level::SSE2: return OverlapMaskSSE2;
+#endif
+        default: return OverlapMaskScalar;
+    }
+}
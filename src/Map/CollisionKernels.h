@@ -0,0 +1,45 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+
+//==============================================================================
+// COLLISION KERNELS
+//==============================================================================
+// Batched rectangle-overlap tests against AABBs stored as flat arrays.
+// Each call tests up to BATCH_SIZE boxes and returns a mask where bit i is set
+// when box i overlaps the query. Overlap is strict, like CheckCollisionRecs.
+class CollisionKernels {
+public:
+    static constexpr int BATCH_SIZE = 32;
+
+    enum class Level {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    using OverlapFn = uint32_t (*)(const Rectangle& query,
+                                   const float* minX, const float* minY,
+                                   const float* maxX, const float* maxY,
+                                   int count);
+
+    // Runs the best kernel supported by the CPU, selected once at start-up
+    static uint32_t OverlapMask(const Rectangle& query,
+                                const float* minX, const float* minY,
+                                const float* maxX, const float* maxY,
+                                int count) {
+        return s_overlap(query, minX, minY, maxX, maxY, count);
+    }
+
+    static Level GetActiveLevel();
+    static const char* GetLevelName(Level level);
+
+    // Returns nullptr when the level is not available on this build or CPU
+    static OverlapFn GetKernel(Level level);
+
+private:
+    static OverlapFn s_overlap;
+    static Level s_activeLevel;
+
+    static Level DetectLevel();
+};
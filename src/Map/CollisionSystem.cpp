@@ -1,55 +1,237 @@
 #include "CollisionSystem.h"
+#include "CollisionKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-std::vector<PositionedCollision> CollisionSystem::GenerateCollisions(const TMJMap& map) {
-    std::vector<PositionedCollision> collisions;
+CollisionWorld CollisionSystem::GenerateCollisions(const TMJMap& map, bool mergeRectangles) {
+    CollisionWorld world;
+    CollisionStore& store = world.store;
+    const TileCollisionTable& templates = map.tileCollisions;
 
-    std::vector<TileLayer> allLayers = map.backgroundLayers;
-    allLayers.insert(allLayers.end(), map.otherLayers.begin(), map.otherLayers.end());
-
-    collisions.reserve(map.width * map.height);
-
-    for (const auto& layer : allLayers) {
+    for (const auto& layer : map.layers) {
         for (int y = 0; y < layer.height; ++y) {
             for (int x = 0; x < layer.width; ++x) {
                 int gid = layer.data[y * layer.width + x];
-                if (gid == 0) continue;
+                if (gid <= 0 || gid >= (int)templates.byGid.size()) continue;
 
-                auto it = map.tileCollisions.find(gid);
-                if (it == map.tileCollisions.end()) continue;
+                const CollisionSpan& span = templates.byGid[gid];
+                if (span.count == 0) continue;
 
-                const TileSet* tileset = MapLoader::FindTilesetForGID(map, gid);
+                int localId = 0;
+                const TileSet* tileset = MapLoader::ResolveGID(map, gid, localId);
                 if (!tileset) continue;
 
-                int localId = gid - tileset->firstGid;
                 Vector2 position = CalculateCollisionPosition(x, y, tileset, localId, map);
 
-                for (const auto& shape : it->second) {
-                    collisions.push_back({shape, position});
+                for (int i = span.first; i < span.first + span.count; ++i) {
+                    AddShape(store, templates.shapes[i], position);
                 }
             }
         }
     }
 
-    return collisions;
+    world.stats.generatedShapes = (int)store.kind.size();
+    if (mergeRectangles) {
+        MergeRectangles(store);
+    }
+    world.stats.bakedShapes = (int)store.kind.size();
+
+    BuildGrid(world, map);
+
+    std::cout << "Collision shapes: " << world.stats.bakedShapes
+              << " (" << (world.stats.generatedShapes - world.stats.bakedShapes)
+              << " removed by rectangle merging)" << std::endl;
+
+    return world;
 }
 
-bool CollisionSystem::CheckPlayerCollision(const Rectangle& playerHitbox, const std::vector<PositionedCollision>& collisions) {
-    for (const auto& collision : collisions) {
-        if (CheckCollisionWithShape(playerHitbox, collision)) {
-            return true;
+void CollisionSystem::QueryCollisions(const CollisionWorld& world, const Rectangle& area, std::vector<int>& results) {
+    results.clear();
+
+    CandidateRange candidates = GatherCandidates(world.grid, area);
+
+    for (int first = 0; first < candidates.count; first += CollisionKernels::BATCH_SIZE) {
+        int count = std::min(CollisionKernels::BATCH_SIZE, candidates.count - first);
+        uint32_t mask = CollisionKernels::OverlapMask(area,
+            candidates.minX + first, candidates.minY + first,
+            candidates.maxX + first, candidates.maxY + first, count);
+
+        while (mask) {
+            results.push_back(candidates.items[first + LowestBit(mask)]);
+            mask &= mask - 1;
         }
     }
-    return false;
+
+    std::sort(results.begin(), results.end());
+    results.erase(std::unique(results.begin(), results.end()), results.end());
+}
+
+//------------------------------------------------------------------------------
+// Shapes the rectangle already overlaps at the start of the motion are
+// ignored, so an entity spawned inside a collider can still walk out. To keep
+// resolved positions from ending up inside a collider through rounding, the
+// reported time stops SWEEP_SKIN pixels short of the contact.
+//------------------------------------------------------------------------------
+static constexpr float SWEEP_SKIN = 0.01f;
+
+SweepResult CollisionSystem::SweepRect(const CollisionWorld& world, const Rectangle& rect, Vector2 delta) {
+    SweepResult result;
+    if (delta.x == 0.0f && delta.y == 0.0f) return result;
+
+    Rectangle sweptBounds = {
+        std::min(rect.x, rect.x + delta.x),
+        std::min(rect.y, rect.y + delta.y),
+        rect.width + std::fabs(delta.x),
+        rect.height + std::fabs(delta.y)
+    };
+
+    thread_local std::vector<int> candidates;
+    QueryCollisions(world, sweptBounds, candidates);
+
+    for (int index : candidates) {
+        SweepResult shapeResult = (world.store.kind[index] == ShapeType::Rectangle)
+            ? SweepAgainstBox(rect, delta, world.store, index)
+            : SweepAgainstShape(rect, delta, world.store, index);
+
+        if (shapeResult.hit && shapeResult.time < result.time) {
+            result = shapeResult;
+        }
+    }
+
+    if (result.hit) {
+        float distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+        result.time = std::max(0.0f, result.time - SWEEP_SKIN / distance);
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// Resolves the motion one axis at a time so that blocking on one axis still
+// lets the other one through, which makes entities slide along walls.
+//------------------------------------------------------------------------------
+Vector2 CollisionSystem::MoveAndSlide(const CollisionWorld& world, const Rectangle& rect, Vector2 delta) {
+    Vector2 moved = {0, 0};
+    Rectangle current = rect;
+
+    if (delta.x != 0.0f) {
+        SweepResult sweep = SweepRect(world, current, {delta.x, 0.0f});
+        moved.x = delta.x * sweep.time;
+        current.x += moved.x;
+    }
+
+    if (delta.y != 0.0f) {
+        SweepResult sweep = SweepRect(world, current, {0.0f, delta.y});
+        moved.y = delta.y * sweep.time;
+    }
+
+    return moved;
+}
+
+//------------------------------------------------------------------------------
+// Swept AABB against a static box (slab method)
+//------------------------------------------------------------------------------
+SweepResult CollisionSystem::SweepAgainstBox(const Rectangle& rect, Vector2 delta, const CollisionStore& store, int index) {
+    SweepResult result;
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    const float rectMin[2] = {rect.x, rect.y};
+    const float rectMax[2] = {rect.x + rect.width, rect.y + rect.height};
+    const float boxMin[2] = {store.minX[index], store.minY[index]};
+    const float boxMax[2] = {store.maxX[index], store.maxY[index]};
+    const float motion[2] = {delta.x, delta.y};
+
+    float entry[2], exit[2];
+    for (int axis = 0; axis < 2; ++axis) {
+        if (motion[axis] > 0.0f) {
+            entry[axis] = (boxMin[axis] - rectMax[axis]) / motion[axis];
+            exit[axis] = (boxMax[axis] - rectMin[axis]) / motion[axis];
+        } else if (motion[axis] < 0.0f) {
+            entry[axis] = (boxMax[axis] - rectMin[axis]) / motion[axis];
+            exit[axis] = (boxMin[axis] - rectMax[axis]) / motion[axis];
+        } else {
+            if (rectMax[axis] <= boxMin[axis] || rectMin[axis] >= boxMax[axis]) return result;
+            entry[axis] = -infinity;
+            exit[axis] = infinity;
+        }
+    }
+
+    int axis = (entry[0] > entry[1]) ? 0 : 1;
+    float timeEntry = entry[axis];
+    float timeExit = std::min(exit[0], exit[1]);
+
+    if (timeEntry >= timeExit || timeEntry < 0.0f || timeEntry >= 1.0f) return result;
+
+    result.hit = true;
+    result.time = timeEntry;
+    if (axis == 0) {
+        result.normal = {motion[0] > 0.0f ? -1.0f : 1.0f, 0.0f};
+    } else {
+        result.normal = {0.0f, motion[1] > 0.0f ? -1.0f : 1.0f};
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// Ellipses, polygons and polylines have no closed-form sweep here: the motion
+// is sampled in steps no longer than half the rectangle's smallest side, so
+// thin shapes cannot be skipped, then the first contact is refined by
+// bisection.
+//------------------------------------------------------------------------------
+SweepResult CollisionSystem::SweepAgainstShape(const Rectangle& rect, Vector2 delta, const CollisionStore& store, int index) {
+    constexpr int MAX_STEPS = 64;
+    constexpr int BISECTION_STEPS = 10;
+
+    SweepResult result;
+    if (CheckCollisionWithShape(rect, store, index)) return result;
+
+    auto overlapsAt = [&](float t) {
+        Rectangle moved = {rect.x + delta.x * t, rect.y + delta.y * t, rect.width, rect.height};
+        return CheckCollisionWithShape(moved, store, index);
+    };
+
+    float stepLength = std::max(0.5f * std::min(rect.width, rect.height), 0.5f);
+    float distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+    int steps = std::clamp((int)std::ceil(distance / stepLength), 1, MAX_STEPS);
+
+    float free = 0.0f;
+    float blocked = -1.0f;
+    for (int i = 1; i <= steps; ++i) {
+        float t = (float)i / (float)steps;
+        if (overlapsAt(t)) {
+            blocked = t;
+            break;
+        }
+        free = t;
+    }
+    if (blocked < 0.0f) return result;
+
+    for (int i = 0; i < BISECTION_STEPS; ++i) {
+        float mid = (free + blocked) * 0.5f;
+        if (overlapsAt(mid)) blocked = mid; else free = mid;
+    }
+
+    result.hit = true;
+    result.time = free;
+
+    // Decide which axis made contact by advancing each one alone
+    Rectangle advanceX = {rect.x + delta.x * blocked, rect.y + delta.y * free, rect.width, rect.height};
+    if (delta.x != 0.0f && (delta.y == 0.0f || CheckCollisionWithShape(advanceX, store, index))) {
+        result.normal = {delta.x > 0.0f ? -1.0f : 1.0f, 0.0f};
+    } else {
+        result.normal = {0.0f, delta.y > 0.0f ? -1.0f : 1.0f};
+    }
+    return result;
 }
 
 Vector2 CollisionSystem::CalculateCollisionPosition(int x, int y, const TileSet* tileset, int localId, const TMJMap& map) {
-    Vector2 position = {(float)(x * map.tileWidth), (float)(y * map.tileHeight)};
+    Vector2 position = {(float)((x + map.originX) * map.tileWidth), (float)((y + map.originY) * map.tileHeight)};
 
     float offsetY = 0.0f;
     if (!tileset->isAtlas) {
-        auto it = tileset->tileImages.find(localId);
-        if (it != tileset->tileImages.end() && it->second && it->second->id != 0) {
-            offsetY = (float)map.tileHeight - (float)it->second->height;
+        auto it = tileset->tileRects.find(localId);
+        if (it != tileset->tileRects.end()) {
+            offsetY = (float)map.tileHeight - it->second.height;
         }
     }
 
@@ -59,30 +241,448 @@ Vector2 CollisionSystem::CalculateCollisionPosition(int x, int y, const TileSet*
     return position;
 }
 
-bool CollisionSystem::CheckCollisionWithShape(const Rectangle& rect, const PositionedCollision& collision) {
-    switch (collision.shape.type) {
-        case ShapeType::Rectangle: {
-            Rectangle shapeRect = {
-                collision.shape.rect.x + collision.position.x,
-                collision.shape.rect.y + collision.position.y,
-                collision.shape.rect.width,
-                collision.shape.rect.height
-            };
-            return CheckCollisionRecs(rect, shapeRect);
-        }
+void CollisionSystem::AddShape(CollisionStore& store, const CollisionShape& shape, Vector2 position) {
+    float minX, minY, maxX, maxY;
+    int firstPoint = (int)store.points.size();
+    int pointCount = 0;
+
+    switch (shape.type) {
+        case ShapeType::Rectangle:
+        case ShapeType::Ellipse:
+            minX = shape.rect.x + position.x;
+            minY = shape.rect.y + position.y;
+            maxX = minX + shape.rect.width;
+            maxY = minY + shape.rect.height;
+            break;
 
-        case ShapeType::Ellipse: {
-            Vector2 center = {
-                collision.shape.rect.x + collision.position.x + collision.shape.rect.width / 2.0f,
-                collision.shape.rect.y + collision.position.y + collision.shape.rect.height / 2.0f
-            };
-            float rx = collision.shape.rect.width / 2.0f;
-            float ry = collision.shape.rect.height / 2.0f;
-            float radius = (rx + ry) / 2.0f; // Approximation
-            return CheckCollisionCircleRec(center, radius, rect);
+        case ShapeType::Polygon:
+        case ShapeType::Polyline: {
+            bool closed = (shape.type == ShapeType::Polygon);
+            if (shape.points.size() < (closed ? 3u : 2u)) return;
+
+            minX = maxX = shape.points[0].x + position.x;
+            minY = maxY = shape.points[0].y + position.y;
+            for (const auto& p : shape.points) {
+                Vector2 world = {p.x + position.x, p.y + position.y};
+                minX = std::min(minX, world.x);
+                maxX = std::max(maxX, world.x);
+                minY = std::min(minY, world.y);
+                maxY = std::max(maxY, world.y);
+                store.points.push_back(world);
+            }
+            pointCount = (int)shape.points.size();
+            BakeEdgeAxes(store, firstPoint, pointCount, closed);
+            break;
         }
 
         default:
+            return; // Unknown shapes never collide
+    }
+
+    store.minX.push_back(minX);
+    store.minY.push_back(minY);
+    store.maxX.push_back(maxX);
+    store.maxY.push_back(maxY);
+    store.kind.push_back(shape.type);
+
+    float radiusX = (maxX - minX) * 0.5f;
+    float radiusY = (maxY - minY) * 0.5f;
+    bool isEllipse = (shape.type == ShapeType::Ellipse);
+    store.invRadiusX.push_back(isEllipse && radiusX > 0.0f ? 1.0f / radiusX : 0.0f);
+    store.invRadiusY.push_back(isEllipse && radiusY > 0.0f ? 1.0f / radiusY : 0.0f);
+    store.firstPoint.push_back(firstPoint);
+    store.pointCount.push_back(pointCount);
+}
+
+bool CollisionSystem::CheckCollisionWithShape(const Rectangle& rect, const CollisionStore& store, int index) {
+    // Broad test against the world bounds, shared by every shape kind
+    if (!(rect.x < store.maxX[index] && rect.x + rect.width > store.minX[index] &&
+          rect.y < store.maxY[index] && rect.y + rect.height > store.minY[index])) {
+        return false;
+    }
+
+    switch (store.kind[index]) {
+        case ShapeType::Rectangle:
+            return true;
+
+        case ShapeType::Ellipse:
+            return CheckCollisionWithEllipse(rect, store, index);
+
+        case ShapeType::Polygon:
+            return CheckCollisionWithPolygon(rect, store, index);
+
+        case ShapeType::Polyline:
+            return CheckCollisionWithPolyline(rect, store, index);
+
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Scaling by the inverse radii turns the ellipse into the unit circle and
+// keeps the rectangle axis-aligned, so the closest point of the rectangle to
+// the centre decides the overlap exactly.
+//------------------------------------------------------------------------------
+bool CollisionSystem::CheckCollisionWithEllipse(const Rectangle& rect, const CollisionStore& store, int index) {
+    const float centerX = (store.minX[index] + store.maxX[index]) * 0.5f;
+    const float centerY = (store.minY[index] + store.maxY[index]) * 0.5f;
+
+    float dx = (std::clamp(centerX, rect.x, rect.x + rect.width) - centerX) * store.invRadiusX[index];
+    float dy = (std::clamp(centerY, rect.y, rect.y + rect.height) - centerY) * store.invRadiusY[index];
+
+    return dx * dx + dy * dy < 1.0f;
+}
+
+//------------------------------------------------------------------------------
+// SAT between a rectangle and a convex polygon. The rectangle axes are already
+// covered by the bounds test, so only the polygon edge normals remain, and the
+// polygon side of each projection was computed at bake time.
+//------------------------------------------------------------------------------
+bool CollisionSystem::CheckCollisionWithPolygon(const Rectangle& rect, const CollisionStore& store, int index) {
+    const float halfWidth = rect.width * 0.5f;
+    const float halfHeight = rect.height * 0.5f;
+    const float centerX = rect.x + halfWidth;
+    const float centerY = rect.y + halfHeight;
+
+    const int first = store.firstPoint[index];
+    const int last = first + store.pointCount[index];
+    for (int i = first; i < last; ++i) {
+        const Vector2& n = store.edgeNormals[i];
+        float center = n.x * centerX + n.y * centerY;
+        float extent = halfWidth * std::fabs(n.x) + halfHeight * std::fabs(n.y);
+
+        if (center + extent <= store.projMin[i] || center - extent >= store.projMax[i]) {
             return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Segment-vs-rectangle per polyline segment: the segment bounds must overlap
+// the rectangle and the segment line must pass strictly through it.
+//------------------------------------------------------------------------------
+bool CollisionSystem::CheckCollisionWithPolyline(const Rectangle& rect, const CollisionStore& store, int index) {
+    const float halfWidth = rect.width * 0.5f;
+    const float halfHeight = rect.height * 0.5f;
+    const float centerX = rect.x + halfWidth;
+    const float centerY = rect.y + halfHeight;
+
+    const int first = store.firstPoint[index];
+    const int last = first + store.pointCount[index] - 1;
+    for (int i = first; i < last; ++i) {
+        const Vector2& a = store.points[i];
+        const Vector2& b = store.points[i + 1];
+
+        if (rect.x >= std::max(a.x, b.x) || rect.x + rect.width <= std::min(a.x, b.x) ||
+            rect.y >= std::max(a.y, b.y) || rect.y + rect.height <= std::min(a.y, b.y)) {
+            continue;
+        }
+
+        const Vector2& n = store.edgeNormals[i];
+        float center = n.x * centerX + n.y * centerY;
+        float extent = halfWidth * std::fabs(n.x) + halfHeight * std::fabs(n.y);
+
+        if (center - extent < store.projMin[i] && center + extent > store.projMin[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CollisionSystem::BakeEdgeAxes(CollisionStore& store, int firstPoint, int pointCount, bool closed) {
+    store.edgeNormals.resize(store.points.size());
+    store.projMin.resize(store.points.size());
+    store.projMax.resize(store.points.size());
+
+    int edgeCount = closed ? pointCount : pointCount - 1;
+    for (int e = 0; e < edgeCount; ++e) {
+        const Vector2& a = store.points[firstPoint + e];
+        const Vector2& b = store.points[firstPoint + (e + 1) % pointCount];
+
+        Vector2 normal = {b.y - a.y, a.x - b.x};
+        float length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+        if (length > 0.0f) {
+            normal.x /= length;
+            normal.y /= length;
+        }
+
+        float minProj = normal.x * a.x + normal.y * a.y;
+        float maxProj = minProj;
+        if (closed) {
+            for (int k = 0; k < pointCount; ++k) {
+                const Vector2& p = store.points[firstPoint + k];
+                float proj = normal.x * p.x + normal.y * p.y;
+                minProj = std::min(minProj, proj);
+                maxProj = std::max(maxProj, proj);
+            }
+        }
+
+        store.edgeNormals[firstPoint + e] = normal;
+        store.projMin[firstPoint + e] = minProj;
+        store.projMax[firstPoint + e] = maxProj;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Greedily fuses rectangles sharing an edge: first runs along rows (same top
+// and bottom, touching or overlapping in x), then the resulting strips along
+// columns (same left and right, touching or overlapping in y). Only unions
+// that are exactly rectangles are formed, so the covered area is unchanged.
+//------------------------------------------------------------------------------
+void CollisionSystem::MergeRectangles(CollisionStore& store) {
+    struct Box { float minX, minY, maxX, maxY; };
+    constexpr float EPSILON = 1e-3f;
+
+    std::vector<Box> boxes;
+    size_t kept = 0;
+    for (size_t i = 0; i < store.kind.size(); ++i) {
+        if (store.kind[i] == ShapeType::Rectangle) {
+            boxes.push_back({store.minX[i], store.minY[i], store.maxX[i], store.maxY[i]});
+            continue;
+        }
+
+        // Compact the other shapes to the front, their point ranges stay valid
+        store.minX[kept] = store.minX[i];
+        store.minY[kept] = store.minY[i];
+        store.maxX[kept] = store.maxX[i];
+        store.maxY[kept] = store.maxY[i];
+        store.kind[kept] = store.kind[i];
+        store.invRadiusX[kept] = store.invRadiusX[i];
+        store.invRadiusY[kept] = store.invRadiusY[i];
+        store.firstPoint[kept] = store.firstPoint[i];
+        store.pointCount[kept] = store.pointCount[i];
+        ++kept;
+    }
+
+    auto sameValue = [](float a, float b) { return std::fabs(a - b) < EPSILON; };
+
+    // Row runs
+    std::sort(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) {
+        if (a.minY != b.minY) return a.minY < b.minY;
+        if (a.maxY != b.maxY) return a.maxY < b.maxY;
+        return a.minX < b.minX;
+    });
+
+    std::vector<Box> rows;
+    for (const auto& box : boxes) {
+        if (!rows.empty()) {
+            Box& last = rows.back();
+            if (sameValue(last.minY, box.minY) && sameValue(last.maxY, box.maxY) && box.minX <= last.maxX + EPSILON) {
+                last.maxX = std::max(last.maxX, box.maxX);
+                continue;
+            }
+        }
+        rows.push_back(box);
+    }
+
+    // Column merge of the row strips
+    std::sort(rows.begin(), rows.end(), [](const Box& a, const Box& b) {
+        if (a.minX != b.minX) return a.minX < b.minX;
+        if (a.maxX != b.maxX) return a.maxX < b.maxX;
+        return a.minY < b.minY;
+    });
+
+    std::vector<Box> merged;
+    for (const auto& box : rows) {
+        if (!merged.empty()) {
+            Box& last = merged.back();
+            if (sameValue(last.minX, box.minX) && sameValue(last.maxX, box.maxX) && box.minY <= last.maxY + EPSILON) {
+                last.maxY = std::max(last.maxY, box.maxY);
+                continue;
+            }
+        }
+        merged.push_back(box);
+    }
+
+    size_t total = kept + merged.size();
+    store.minX.resize(total);
+    store.minY.resize(total);
+    store.maxX.resize(total);
+    store.maxY.resize(total);
+    store.kind.resize(total);
+    store.invRadiusX.resize(total);
+    store.invRadiusY.resize(total);
+    store.firstPoint.resize(total);
+    store.pointCount.resize(total);
+
+    for (size_t i = 0; i < merged.size(); ++i) {
+        size_t index = kept + i;
+        store.minX[index] = merged[i].minX;
+        store.minY[index] = merged[i].minY;
+        store.maxX[index] = merged[i].maxX;
+        store.maxY[index] = merged[i].maxY;
+        store.kind[index] = ShapeType::Rectangle;
+        store.invRadiusX[index] = 0.0f;
+        store.invRadiusY[index] = 0.0f;
+        store.firstPoint[index] = (int)store.points.size();
+        store.pointCount[index] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// The grid covers the map with one cell per tile. Anything lying outside the
+// map is clamped into the border cells, both when inserting and querying, so
+// overlapping rectangles always share at least one cell.
+//------------------------------------------------------------------------------
+void CollisionSystem::BuildGrid(CollisionWorld& world, const TMJMap& map) {
+    const CollisionStore& store = world.store;
+    CollisionGrid& grid = world.grid;
+    grid = CollisionGrid{};
+
+    if (map.width <= 0 || map.height <= 0 || map.tileWidth <= 0 || map.tileHeight <= 0) return;
+
+    grid.cellWidth = (float)map.tileWidth;
+    grid.cellHeight = (float)map.tileHeight;
+    grid.columns = map.width;
+    grid.rows = map.height;
+    grid.origin = {map.originX * grid.cellWidth, map.originY * grid.cellHeight};
+
+    const size_t cellCount = (size_t)grid.columns * grid.rows;
+    const int shapeCount = (int)store.kind.size();
+    grid.cellStart.assign(cellCount + 1, 0);
+
+    // First pass: count entries per cell
+    for (int index = 0; index < shapeCount; ++index) {
+        Rectangle bounds = {
+            store.minX[index], store.minY[index],
+            store.maxX[index] - store.minX[index], store.maxY[index] - store.minY[index]
+        };
+
+        int minCol, minRow, maxCol, maxRow;
+        GetCellRange(grid, bounds, minCol, minRow, maxCol, maxRow);
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                grid.cellStart[row * grid.columns + col + 1]++;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < cellCount; ++i) {
+        grid.cellStart[i + 1] += grid.cellStart[i];
+    }
+
+    // Second pass: scatter shape indices and bounds into their cells
+    const size_t itemCount = grid.cellStart[cellCount];
+    grid.cellItems.resize(itemCount);
+    grid.itemMinX.resize(itemCount);
+    grid.itemMinY.resize(itemCount);
+    grid.itemMaxX.resize(itemCount);
+    grid.itemMaxY.resize(itemCount);
+    std::vector<int> cursor(grid.cellStart.begin(), grid.cellStart.end() - 1);
+
+    for (int index = 0; index < shapeCount; ++index) {
+        Rectangle bounds = {
+            store.minX[index], store.minY[index],
+            store.maxX[index] - store.minX[index], store.maxY[index] - store.minY[index]
+        };
+
+        int minCol, minRow, maxCol, maxRow;
+        GetCellRange(grid, bounds, minCol, minRow, maxCol, maxRow);
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                int slot = cursor[row * grid.columns + col]++;
+                grid.cellItems[slot] = index;
+                grid.itemMinX[slot] = store.minX[index];
+                grid.itemMinY[slot] = store.minY[index];
+                grid.itemMaxX[slot] = store.maxX[index];
+                grid.itemMaxY[slot] = store.maxY[index];
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Cells are stored row-major, so the cells a query overlaps on one row already
+// form a contiguous run of items. A query within a single row is answered from
+// the grid arrays directly; otherwise the rows are appended into a scratch
+// buffer so the kernels see full batches rather than the handful of shapes
+// each cell holds.
+//------------------------------------------------------------------------------
+CollisionSystem::CandidateRange CollisionSystem::GatherCandidates(const CollisionGrid& grid, const Rectangle& area) {
+    CandidateRange range;
+
+    int minCol, minRow, maxCol, maxRow;
+    if (!GetCellRange(grid, area, minCol, minRow, maxCol, maxRow)) return range;
+
+    if (minRow == maxRow) {
+        int first = grid.cellStart[minRow * grid.columns + minCol];
+        int last = grid.cellStart[minRow * grid.columns + maxCol + 1];
+        range.count = last - first;
+        if (range.count == 0) return range;
+
+        range.items = &grid.cellItems[first];
+        range.minX = &grid.itemMinX[first];
+        range.minY = &grid.itemMinY[first];
+        range.maxX = &grid.itemMaxX[first];
+        range.maxY = &grid.itemMaxY[first];
+        return range;
+    }
+
+    int total = 0;
+    for (int row = minRow; row <= maxRow; ++row) {
+        total += grid.cellStart[row * grid.columns + maxCol + 1] - grid.cellStart[row * grid.columns + minCol];
+    }
+    if (total == 0) return range;
+
+    // Grow-only, so the per-query cost is the copy itself
+    struct Scratch {
+        std::vector<int> items;
+        std::vector<float> minX, minY, maxX, maxY;
+    };
+    thread_local Scratch scratch;
+    if ((int)scratch.items.size() < total) {
+        scratch.items.resize(total);
+        scratch.minX.resize(total);
+        scratch.minY.resize(total);
+        scratch.maxX.resize(total);
+        scratch.maxY.resize(total);
+    }
+
+    int out = 0;
+    for (int row = minRow; row <= maxRow; ++row) {
+        int first = grid.cellStart[row * grid.columns + minCol];
+        int last = grid.cellStart[row * grid.columns + maxCol + 1];
+        for (int slot = first; slot < last; ++slot, ++out) {
+            scratch.items[out] = grid.cellItems[slot];
+            scratch.minX[out] = grid.itemMinX[slot];
+            scratch.minY[out] = grid.itemMinY[slot];
+            scratch.maxX[out] = grid.itemMaxX[slot];
+            scratch.maxY[out] = grid.itemMaxY[slot];
+        }
+    }
+
+    range.count = total;
+    range.items = scratch.items.data();
+    range.minX = scratch.minX.data();
+    range.minY = scratch.minY.data();
+    range.maxX = scratch.maxX.data();
+    range.maxY = scratch.maxY.data();
+    return range;
+}
+
+bool CollisionSystem::GetCellRange(const CollisionGrid& grid, const Rectangle& area, int& minCol, int& minRow, int& maxCol, int& maxRow) {
+    if (grid.columns <= 0 || grid.rows <= 0) return false;
+
+    float x = area.x - grid.origin.x;
+    float y = area.y - grid.origin.y;
+    minCol = std::clamp((int)std::floor(x / grid.cellWidth), 0, grid.columns - 1);
+    minRow = std::clamp((int)std::floor(y / grid.cellHeight), 0, grid.rows - 1);
+    maxCol = std::clamp((int)std::floor((x + area.width) / grid.cellWidth), 0, grid.columns - 1);
+    maxRow = std::clamp((int)std::floor((y + area.height) / grid.cellHeight), 0, grid.rows - 1);
+    return true;
+}
+
+int CollisionSystem::LowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        ++bit;
     }
+    return bit;
+#endif
 }
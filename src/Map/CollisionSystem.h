@@ -1,14 +1,40 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include "TMJTypes.h"
 #include "MapLoader.h"
 
 class CollisionSystem {
 public:
-    static std::vector<PositionedCollision> GenerateCollisions(const TMJMap& map);
-    static bool CheckPlayerCollision(const Rectangle& playerHitbox, const std::vector<PositionedCollision>& collisions);
+    static CollisionWorld GenerateCollisions(const TMJMap& map, bool mergeRectangles = true);
+    static void QueryCollisions(const CollisionWorld& world, const Rectangle& area, std::vector<int>& results);
+    static SweepResult SweepRect(const CollisionWorld& world, const Rectangle& rect, Vector2 delta);
+    static Vector2 MoveAndSlide(const CollisionWorld& world, const Rectangle& rect, Vector2 delta);
 
 private:
+    // Broadphase candidates of one query laid out as flat arrays, ready for
+    // the overlap kernels
+    struct CandidateRange {
+        const int* items = nullptr;
+        const float* minX = nullptr;
+        const float* minY = nullptr;
+        const float* maxX = nullptr;
+        const float* maxY = nullptr;
+        int count = 0;
+    };
+
     static Vector2 CalculateCollisionPosition(int x, int y, const TileSet* tileset, int localId, const TMJMap& map);
-    static bool CheckCollisionWithShape(const Rectangle& rect, const PositionedCollision& collision);
+    static void AddShape(CollisionStore& store, const CollisionShape& shape, Vector2 position);
+    static void BakeEdgeAxes(CollisionStore& store, int firstPoint, int pointCount, bool closed);
+    static bool CheckCollisionWithShape(const Rectangle& rect, const CollisionStore& store, int index);
+    static bool CheckCollisionWithEllipse(const Rectangle& rect, const CollisionStore& store, int index);
+    static bool CheckCollisionWithPolygon(const Rectangle& rect, const CollisionStore& store, int index);
+    static bool CheckCollisionWithPolyline(const Rectangle& rect, const CollisionStore& store, int index);
+    static SweepResult SweepAgainstBox(const Rectangle& rect, Vector2 delta, const CollisionStore& store, int index);
+    static SweepResult SweepAgainstShape(const Rectangle& rect, Vector2 delta, const CollisionStore& store, int index);
+    static void MergeRectangles(CollisionStore& store);
+    static void BuildGrid(CollisionWorld& world, const TMJMap& map);
+    static int LowestBit(uint32_t mask);
+    static CandidateRange GatherCandidates(const CollisionGrid& grid, const Rectangle& area);
+    static bool GetCellRange(const CollisionGrid& grid, const Rectangle& area, int& minCol, int& minRow, int& maxCol, int& maxRow);
 };
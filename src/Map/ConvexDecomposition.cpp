@@ -0,0 +1,243 @@
+#include "ConvexDecomposition.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static constexpr float GEOMETRY_EPSILON = 1e-4f;
+
+//==============================================================================
+// HELPERS
+//==============================================================================
+float ConvexDecomposition::Cross(Vector2 o, Vector2 a, Vector2 b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+float ConvexDecomposition::SignedArea(const std::vector<Vector2>& polygon) {
+    float area = 0.0f;
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        const Vector2& a = polygon[i];
+        const Vector2& b = polygon[(i + 1) % polygon.size()];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return area * 0.5f;
+}
+
+bool ConvexDecomposition::PointInTriangle(Vector2 p, Vector2 a, Vector2 b, Vector2 c) {
+    return Cross(a, b, p) >= -GEOMETRY_EPSILON &&
+           Cross(b, c, p) >= -GEOMETRY_EPSILON &&
+           Cross(c, a, p) >= -GEOMETRY_EPSILON;
+}
+
+//------------------------------------------------------------------------------
+// Drops repeated vertices and, for closed shapes, collinear ones. The result
+// of a closed polygon is counter-clockwise (positive signed area).
+//------------------------------------------------------------------------------
+std::vector<Vector2> ConvexDecomposition::Simplify(const std::vector<Vector2>& polygon, bool closed) {
+    std::vector<Vector2> result;
+    result.reserve(polygon.size());
+
+    for (const auto& p : polygon) {
+        if (!result.empty() &&
+            std::fabs(result.back().x - p.x) < GEOMETRY_EPSILON &&
+            std::fabs(result.back().y - p.y) < GEOMETRY_EPSILON) {
+            continue;
+        }
+        result.push_back(p);
+    }
+
+    if (!closed) return result;
+
+    while (result.size() > 1 &&
+           std::fabs(result.front().x - result.back().x) < GEOMETRY_EPSILON &&
+           std::fabs(result.front().y - result.back().y) < GEOMETRY_EPSILON) {
+        result.pop_back();
+    }
+
+    bool removed = true;
+    while (removed && result.size() > 3) {
+        removed = false;
+        for (size_t i = 0; i < result.size(); ++i) {
+            const Vector2& prev = result[(i + result.size() - 1) % result.size()];
+            const Vector2& next = result[(i + 1) % result.size()];
+            if (std::fabs(Cross(prev, result[i], next)) < GEOMETRY_EPSILON) {
+                result.erase(result.begin() + i);
+                removed = true;
+                break;
+            }
+        }
+    }
+
+    if (SignedArea(result) < 0.0f) {
+        std::reverse(result.begin(), result.end());
+    }
+
+    return result;
+}
+
+bool ConvexDecomposition::IsConvex(const std::vector<Vector2>& polygon) {
+    if (polygon.size() < 3) return false;
+
+    bool hasPositive = false;
+    bool hasNegative = false;
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        float cross = Cross(polygon[i],
+                            polygon[(i + 1) % polygon.size()],
+                            polygon[(i + 2) % polygon.size()]);
+        if (cross > GEOMETRY_EPSILON) hasPositive = true;
+        if (cross < -GEOMETRY_EPSILON) hasNegative = true;
+    }
+    return !(hasPositive && hasNegative);
+}
+
+//==============================================================================
+// EAR CLIPPING
+//==============================================================================
+// Expects a simplified counter-clockwise polygon. Returns vertex index triples;
+// `leftover` receives the vertices that could not be clipped, if any.
+std::vector<std::vector<int>> ConvexDecomposition::Triangulate(const std::vector<Vector2>& polygon,
+                                                               std::vector<int>& leftover) {
+    std::vector<std::vector<int>> triangles;
+    leftover.clear();
+    std::vector<int> remaining(polygon.size());
+    std::iota(remaining.begin(), remaining.end(), 0);
+
+    while (remaining.size() > 3) {
+        bool clipped = false;
+        const size_t count = remaining.size();
+
+        for (size_t i = 0; i < count; ++i) {
+            int prev = remaining[(i + count - 1) % count];
+            int cur = remaining[i];
+            int next = remaining[(i + 1) % count];
+
+            // Reflex vertices cannot be ears
+            if (Cross(polygon[prev], polygon[cur], polygon[next]) <= GEOMETRY_EPSILON) continue;
+
+            bool containsVertex = false;
+            for (int other : remaining) {
+                if (other == prev || other == cur || other == next) continue;
+                if (PointInTriangle(polygon[other], polygon[prev], polygon[cur], polygon[next])) {
+                    containsVertex = true;
+                    break;
+                }
+            }
+            if (containsVertex) continue;
+
+            triangles.push_back({prev, cur, next});
+            remaining.erase(remaining.begin() + i);
+            clipped = true;
+            break;
+        }
+
+        // Self-intersecting input: hand back what is left
+        if (!clipped) {
+            leftover = std::move(remaining);
+            return triangles;
+        }
+    }
+
+    triangles.push_back(remaining);
+    return triangles;
+}
+
+//------------------------------------------------------------------------------
+// Andrew's monotone chain, counter-clockwise without collinear points
+//------------------------------------------------------------------------------
+std::vector<Vector2> ConvexDecomposition::ConvexHull(std::vector<Vector2> points) {
+    if (points.size() < 3) return {};
+
+    std::sort(points.begin(), points.end(), [](const Vector2& a, const Vector2& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+
+    std::vector<Vector2> hull(points.size() * 2);
+    size_t count = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        while (count >= 2 && Cross(hull[count - 2], hull[count - 1], points[i]) <= GEOMETRY_EPSILON) count--;
+        hull[count++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = count + 1; i-- > 0;) {
+        while (count >= lower && Cross(hull[count - 2], hull[count - 1], points[i]) <= GEOMETRY_EPSILON) count--;
+        hull[count++] = points[i];
+    }
+
+    hull.resize(count - 1);
+    if (hull.size() < 3) return {};
+    return hull;
+}
+
+//==============================================================================
+// HERTEL-MEHLHORN MERGE
+//==============================================================================
+bool ConvexDecomposition::TryMerge(const std::vector<int>& a, const std::vector<int>& b,
+                                   const std::vector<Vector2>& polygon, std::vector<int>& merged) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        int u = a[i];
+        int v = a[(i + 1) % a.size()];
+
+        for (size_t j = 0; j < b.size(); ++j) {
+            if (b[j] != v || b[(j + 1) % b.size()] != u) continue;
+
+            // Walk a from v around to u, then b strictly between u and v
+            merged.clear();
+            for (size_t k = 0; k < a.size(); ++k) {
+                merged.push_back(a[(i + 1 + k) % a.size()]);
+            }
+            for (size_t k = 2; k < b.size(); ++k) {
+                merged.push_back(b[(j + k) % b.size()]);
+            }
+
+            std::vector<Vector2> points;
+            for (int index : merged) points.push_back(polygon[index]);
+            return IsConvex(points);
+        }
+    }
+    return false;
+}
+
+//==============================================================================
+// DECOMPOSE
+//==============================================================================
+std::vector<std::vector<Vector2>> ConvexDecomposition::Decompose(const std::vector<Vector2>& polygon, bool& approximated) {
+    approximated = false;
+    std::vector<Vector2> simple = Simplify(polygon, true);
+    if (simple.size() < 3) return {};
+    if (IsConvex(simple)) return {simple};
+
+    std::vector<int> leftover;
+    std::vector<std::vector<int>> pieces = Triangulate(simple, leftover);
+
+    bool mergedAny = true;
+    std::vector<int> merged;
+    while (mergedAny) {
+        mergedAny = false;
+        for (size_t i = 0; i < pieces.size() && !mergedAny; ++i) {
+            for (size_t j = i + 1; j < pieces.size(); ++j) {
+                if (TryMerge(pieces[i], pieces[j], simple, merged)) {
+                    pieces[i] = merged;
+                    pieces.erase(pieces.begin() + j);
+                    mergedAny = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<Vector2>> result;
+    result.reserve(pieces.size());
+    for (const auto& piece : pieces) {
+        std::vector<Vector2> points;
+        for (int index : piece) points.push_back(simple[index]);
+        result.push_back(points);
+    }
+
+    // Unclipped remainder: its hull covers it, and more
+    if (!leftover.empty()) {
+        std::vector<Vector2> points;
+        for (int index : leftover) points.push_back(simple[index]);
+        std::vector<Vector2> hull = ConvexHull(std::move(points));
+        if (!hull.empty()) result.push_back(std::move(hull));
+        approximated = true;
+    }
+    return result;
+}
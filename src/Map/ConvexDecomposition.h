@@ -0,0 +1,26 @@
+#pragma once
+#include <raylib.h>
+#include <vector>
+
+//==============================================================================
+// CONVEX DECOMPOSITION
+//==============================================================================
+// Splits simple polygons into convex pieces (ear clipping followed by a
+// Hertel-Mehlhorn merge of the triangles) so they can be tested with SAT.
+// Self-intersecting polygons cannot be fully clipped: the part left over is
+// covered by its convex hull and `approximated` is set.
+class ConvexDecomposition {
+public:
+    static std::vector<std::vector<Vector2>> Decompose(const std::vector<Vector2>& polygon, bool& approximated);
+    static bool IsConvex(const std::vector<Vector2>& polygon);
+    static std::vector<Vector2> Simplify(const std::vector<Vector2>& polygon, bool closed);
+
+private:
+    static float Cross(Vector2 o, Vector2 a, Vector2 b);
+    static float SignedArea(const std::vector<Vector2>& polygon);
+    static bool PointInTriangle(Vector2 p, Vector2 a, Vector2 b, Vector2 c);
+    static std::vector<std::vector<int>> Triangulate(const std::vector<Vector2>& polygon, std::vector<int>& leftover);
+    static std::vector<Vector2> ConvexHull(std::vector<Vector2> points);
+    static bool TryMerge(const std::vector<int>& a, const std::vector<int>& b,
+                         const std::vector<Vector2>& polygon, std::vector<int>& merged);
+};
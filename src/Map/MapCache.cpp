@@ -0,0 +1,610 @@
+#include "MapCache.h"
+#include "MapLoader.h"
+#include "../Core/MappedFile.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+
+static constexpr char CACHE_MAGIC[8] = {'R', 'P', 'G', 'B', 'A', 'K', 'E', '\0'};
+
+// Struct sizes baked into the header: a cache written by a build with a
+// different layout is rejected instead of misread
+static constexpr uint32_t LAYOUT_SIGNATURE =
+    (uint32_t)(sizeof(Tile) | (sizeof(void*) << 8) | (sizeof(GidEntry) << 16) | (sizeof(CollisionSpan) << 24));
+
+namespace {
+
+    //--------------------------------------------------------------------------
+    // Binary writer
+    //--------------------------------------------------------------------------
+    class CacheWriter {
+    public:
+        explicit CacheWriter(std::ofstream& out) : m_out(out) {}
+
+        template <typename T>
+        void Write(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "raw write of a non-POD type");
+            m_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        void WriteVector(const std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable<T>::value, "raw write of a non-POD type");
+            Write((uint64_t)values.size());
+            if (!values.empty()) {
+                m_out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+            }
+        }
+
+        void WriteString(const std::string& value) {
+            Write((uint32_t)value.size());
+            m_out.write(value.data(), value.size());
+        }
+
+        bool Good() const { return m_out.good(); }
+
+    private:
+        std::ofstream& m_out;
+    };
+
+    //--------------------------------------------------------------------------
+    // Bounds-checked reader over the mapped cache
+    //--------------------------------------------------------------------------
+    class CacheReader {
+    public:
+        CacheReader(const unsigned char* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+        template <typename T>
+        bool Read(T& value) {
+            if ((size_t)(m_end - m_cursor) < sizeof(T)) return Fail();
+            std::memcpy(&value, m_cursor, sizeof(T));
+            m_cursor += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool ReadVector(std::vector<T>& values) {
+            uint64_t count = 0;
+            if (!Read(count) || count > (uint64_t)(m_end - m_cursor) / sizeof(T)) return Fail();
+            values.resize((size_t)count);
+            if (count > 0) {
+                std::memcpy(values.data(), m_cursor, (size_t)count * sizeof(T));
+                m_cursor += (size_t)count * sizeof(T);
+            }
+            return true;
+        }
+
+        bool ReadString(std::string& value) {
+            uint32_t length = 0;
+            if (!Read(length) || length > (size_t)(m_end - m_cursor)) return Fail();
+            value.assign(reinterpret_cast<const char*>(m_cursor), length);
+            m_cursor += length;
+            return true;
+        }
+
+        bool Good() const { return m_ok; }
+
+    private:
+        const unsigned char* m_cursor;
+        const unsigned char* m_end;
+        bool m_ok = true;
+
+        bool Fail() {
+            m_ok = false;
+            m_cursor = m_end;
+            return false;
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    // Tiles: the tileset pointer is stored as an index into map.tilesets
+    //--------------------------------------------------------------------------
+    void WriteTiles(CacheWriter& writer, const std::vector<Tile>& tiles, const TMJMap& map) {
+        std::vector<Tile> stripped(tiles);
+        std::vector<int32_t> tilesetIndices(tiles.size(), -1);
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            if (tiles[i].tileset) {
+                tilesetIndices[i] = (int32_t)(tiles[i].tileset - map.tilesets.data());
+            }
+            stripped[i].tileset = nullptr;
+        }
+        writer.WriteVector(tilesetIndices);
+        writer.WriteVector(stripped);
+    }
+
+    bool ReadTiles(CacheReader& reader, std::vector<Tile>& tiles, std::vector<int32_t>& tilesetIndices) {
+        return reader.ReadVector(tilesetIndices) && reader.ReadVector(tiles) &&
+               tilesetIndices.size() == tiles.size();
+    }
+
+    void LinkTiles(std::vector<Tile>& tiles, const std::vector<int32_t>& tilesetIndices, const TMJMap& map) {
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            int index = tilesetIndices[i];
+            const TileSet* tileset = (index >= 0 && index < (int)map.tilesets.size()) ? &map.tilesets[index] : nullptr;
+            tiles[i].tileset = tileset;
+
+            // Atlas page placement is redone at load: take the current rect
+            if (tileset && tiles[i].isImageCollection) {
+                auto rect = tileset->tileRects.find(tiles[i].localId);
+                if (rect != tileset->tileRects.end()) {
+                    tiles[i].source = rect->second;
+                } else {
+                    tiles[i].tileset = nullptr;
+                }
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Files a map depends on besides its source
+    //--------------------------------------------------------------------------
+    std::vector<std::string> GetDependencies(const TMJMap& map) {
+        std::vector<std::string> paths;
+        for (const auto& tileset : map.tilesets) {
+            if (!tileset.sourcePath.empty()) paths.push_back(tileset.sourcePath);
+            if (!tileset.imagePath.empty()) paths.push_back(tileset.imagePath);
+            for (const auto& [localId, path] : tileset.tileImagePaths) {
+                paths.push_back(path);
+            }
+        }
+        return paths;
+    }
+
+    //--------------------------------------------------------------------------
+    // Consistency of the loaded arrays: a cache of the right size can still
+    // hold indices that would be read out of bounds at runtime
+    //--------------------------------------------------------------------------
+
+    // CSR offsets: one per cell plus the end, from 0 up to itemCount
+    bool IsValidCellStart(const std::vector<int>& cellStart, int64_t cellCount, size_t itemCount) {
+        if (cellCount < 0 || (uint64_t)cellStart.size() != (uint64_t)cellCount + 1) return false;
+        if (cellStart.front() != 0 || (size_t)cellStart.back() != itemCount) return false;
+        for (size_t i = 1; i < cellStart.size(); ++i) {
+            if (cellStart[i] < cellStart[i - 1]) return false;
+        }
+        return true;
+    }
+
+    bool IsValidIndexList(const std::vector<int>& indices, size_t count) {
+        for (int index : indices) {
+            if (index < 0 || (size_t)index >= count) return false;
+        }
+        return true;
+    }
+
+    bool IsValidStore(const CollisionStore& store) {
+        const size_t shapeCount = store.minX.size();
+        for (size_t size : {store.minY.size(), store.maxX.size(), store.maxY.size(), store.kind.size(),
+                            store.invRadiusX.size(), store.invRadiusY.size(), store.firstPoint.size(),
+                            store.pointCount.size()}) {
+            if (size != shapeCount) return false;
+        }
+
+        // The SAT arrays run parallel to the point pool
+        const size_t pointCount = store.points.size();
+        if (store.edgeNormals.size() != pointCount || store.projMin.size() != pointCount ||
+            store.projMax.size() != pointCount) {
+            return false;
+        }
+        for (size_t i = 0; i < shapeCount; ++i) {
+            int64_t first = store.firstPoint[i];
+            int64_t count = store.pointCount[i];
+            if (first < 0 || count < 0 || first + count > (int64_t)pointCount) return false;
+        }
+        return true;
+    }
+
+    bool IsValidCollisionGrid(const CollisionGrid& grid, size_t shapeCount) {
+        const size_t itemCount = grid.cellItems.size();
+        return grid.columns >= 0 && grid.rows >= 0 &&
+               IsValidCellStart(grid.cellStart, (int64_t)grid.columns * grid.rows, itemCount) &&
+               IsValidIndexList(grid.cellItems, shapeCount) &&
+               grid.itemMinX.size() == itemCount && grid.itemMinY.size() == itemCount &&
+               grid.itemMaxX.size() == itemCount && grid.itemMaxY.size() == itemCount;
+    }
+
+    bool IsValidCollisionTable(const TileCollisionTable& table) {
+        for (const CollisionSpan& span : table.byGid) {
+            if (span.first < 0 || span.count < 0 ||
+                (int64_t)span.first + span.count > (int64_t)table.shapes.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool IsConsistent(const TMJMap& map, const TileGrid& grid, const std::vector<Tile>& objects,
+                      const SpriteIndex& index, const CollisionWorld& world) {
+        for (const GidEntry& entry : map.gidLookup) {
+            if (entry.tilesetIndex >= (int)map.tilesets.size()) return false;
+        }
+        return IsValidCollisionTable(map.tileCollisions) &&
+               grid.layerCount >= 0 && grid.columns >= 0 && grid.rows >= 0 &&
+               IsValidCellStart(grid.cellStart, (int64_t)grid.layerCount * grid.rows * grid.columns,
+                                grid.tiles.size()) &&
+               index.columns >= 0 && index.rows >= 0 &&
+               IsValidCellStart(index.cellStart, (int64_t)index.columns * index.rows, index.cellItems.size()) &&
+               IsValidIndexList(index.cellItems, objects.size()) &&
+               IsValidStore(world.store) &&
+               IsValidCollisionGrid(world.grid, world.store.minX.size());
+    }
+}
+
+//==============================================================================
+// STAMP
+//==============================================================================
+std::string MapCache::GetCachePath(const std::string& mapPath) {
+    return mapPath + ".bake";
+}
+
+// FNV-1a, 64 bits
+uint64_t MapCache::HashBytes(const unsigned char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool MapCache::ComputeStamp(const std::string& path, SourceStamp& stamp, bool withHash) {
+    if (!FileExists(path.c_str())) return false;
+
+    stamp.modTime = (int64_t)GetFileModTime(path.c_str());
+    stamp.size = (uint64_t)GetFileLength(path.c_str());
+    stamp.hash = 0;
+
+    if (withHash) {
+        MappedFile source;
+        if (!source.Open(path)) return false;
+        stamp.size = source.GetSize();
+        stamp.hash = HashBytes(source.GetData(), source.GetSize());
+    }
+    return true;
+}
+
+//==============================================================================
+// SAVE
+//==============================================================================
+bool MapCache::Save(const std::string& mapPath, const TMJMap& map, const TileGrid& backgroundTiles,
+                    const std::vector<Tile>& objectTiles, const SpriteIndex& objectIndex,
+                    const CollisionWorld& collisions) {
+    // Infinite maps are streamed: their tiles and collisions only ever cover
+    // the current region, so there is nothing complete to bake
+    if (map.infinite) return false;
+
+    // An empty world would be served from the cache until the source changes
+    if (map.layers.empty()) {
+        std::cerr << "Warning: " << mapPath << " has no layers, map cache not written" << std::endl;
+        return false;
+    }
+
+    SourceStamp stamp;
+    if (!ComputeStamp(mapPath, stamp, true)) return false;
+
+    const std::string cachePath = GetCachePath(mapPath);
+    const std::string tempPath = cachePath + ".tmp";
+
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Warning: Unable to write map cache " << cachePath << std::endl;
+        return false;
+    }
+
+    CacheWriter writer(out);
+
+    // Header
+    out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    writer.Write(VERSION);
+    writer.Write(LAYOUT_SIGNATURE);
+    writer.Write(stamp);
+
+    std::vector<std::string> dependencies = GetDependencies(map);
+    writer.Write((uint32_t)dependencies.size());
+    for (const auto& path : dependencies) {
+        SourceStamp dependency;
+        ComputeStamp(path, dependency, false);
+        writer.WriteString(path);
+        writer.Write(dependency.size);
+        writer.Write(dependency.modTime);
+    }
+
+    // Map and tilesets
+    writer.Write(map.width);
+    writer.Write(map.height);
+    writer.Write(map.tileWidth);
+    writer.Write(map.tileHeight);
+
+    writer.Write((uint32_t)map.tilesets.size());
+    for (const auto& tileset : map.tilesets) {
+        writer.Write(tileset.firstGid);
+        writer.Write(tileset.tileCount);
+        writer.Write(tileset.tileWidth);
+        writer.Write(tileset.tileHeight);
+        writer.Write(tileset.columns);
+        writer.Write(tileset.isAtlas);
+        writer.Write(tileset.tileOffsetX);
+        writer.Write(tileset.tileOffsetY);
+        writer.WriteString(tileset.sourcePath);
+        writer.WriteString(tileset.imagePath);
+        writer.Write((uint32_t)tileset.tileImagePaths.size());
+        for (const auto& [localId, path] : tileset.tileImagePaths) {
+            writer.Write(localId);
+            writer.WriteString(path);
+        }
+    }
+
+    // Layers
+    writer.Write((uint32_t)map.layers.size());
+    for (const auto& layer : map.layers) {
+        writer.Write(layer.width);
+        writer.Write(layer.height);
+        writer.Write(layer.group);
+        writer.WriteVector(layer.data);
+    }
+
+    // Collision templates and GID table
+    writer.WriteVector(map.tileCollisions.byGid);
+    writer.Write((uint32_t)map.tileCollisions.shapes.size());
+    for (const auto& shape : map.tileCollisions.shapes) {
+        writer.Write(shape.type);
+        writer.Write(shape.rect);
+        writer.WriteVector(shape.points);
+    }
+    writer.WriteVector(map.gidLookup);
+
+    // Generated tiles
+    writer.Write(backgroundTiles.layerCount);
+    writer.Write(backgroundTiles.columns);
+    writer.Write(backgroundTiles.rows);
+    writer.Write(backgroundTiles.cellWidth);
+    writer.Write(backgroundTiles.cellHeight);
+    writer.Write(backgroundTiles.margin);
+    writer.WriteVector(backgroundTiles.cellStart);
+    WriteTiles(writer, backgroundTiles.tiles, map);
+
+    WriteTiles(writer, objectTiles, map);
+    writer.Write(objectIndex.columns);
+    writer.Write(objectIndex.rows);
+    writer.Write(objectIndex.cellWidth);
+    writer.Write(objectIndex.cellHeight);
+    writer.WriteVector(objectIndex.cellStart);
+    writer.WriteVector(objectIndex.cellItems);
+
+    // Baked collisions
+    const CollisionStore& store = collisions.store;
+    writer.WriteVector(store.minX);
+    writer.WriteVector(store.minY);
+    writer.WriteVector(store.maxX);
+    writer.WriteVector(store.maxY);
+    writer.WriteVector(store.kind);
+    writer.WriteVector(store.invRadiusX);
+    writer.WriteVector(store.invRadiusY);
+    writer.WriteVector(store.firstPoint);
+    writer.WriteVector(store.pointCount);
+    writer.WriteVector(store.points);
+    writer.WriteVector(store.edgeNormals);
+    writer.WriteVector(store.projMin);
+    writer.WriteVector(store.projMax);
+
+    const CollisionGrid& grid = collisions.grid;
+    writer.Write(grid.cellWidth);
+    writer.Write(grid.cellHeight);
+    writer.Write(grid.columns);
+    writer.Write(grid.rows);
+    writer.WriteVector(grid.cellStart);
+    writer.WriteVector(grid.cellItems);
+    writer.WriteVector(grid.itemMinX);
+    writer.WriteVector(grid.itemMinY);
+    writer.WriteVector(grid.itemMaxX);
+    writer.WriteVector(grid.itemMaxY);
+    writer.Write(collisions.stats);
+
+    bool ok = writer.Good();
+    out.close();
+
+    // Replace the previous cache only once the new one is complete
+    std::remove(cachePath.c_str());
+    if (!ok || std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        std::cerr << "Warning: Unable to write map cache " << cachePath << std::endl;
+        return false;
+    }
+
+    std::cout << "Map cache written: " << cachePath << std::endl;
+    return true;
+}
+
+//==============================================================================
+// LOAD
+//==============================================================================
+bool MapCache::Load(const std::string& mapPath, TMJMap& map, TileGrid& backgroundTiles,
+                    std::vector<Tile>& objectTiles, SpriteIndex& objectIndex, CollisionWorld& collisions) {
+    auto start = std::chrono::steady_clock::now();
+
+    const std::string cachePath = GetCachePath(mapPath);
+    MappedFile file;
+    if (!file.Open(cachePath)) return false;
+
+    CacheReader reader(file.GetData(), file.GetSize());
+
+    // Header and staleness checks
+    char magic[sizeof(CACHE_MAGIC)];
+    uint32_t version = 0, layout = 0;
+    SourceStamp stored;
+    if (!reader.Read(magic) || std::memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        !reader.Read(version) || version != VERSION ||
+        !reader.Read(layout) || layout != LAYOUT_SIGNATURE || !reader.Read(stored)) {
+        std::cout << "Map cache: " << cachePath << " has an old format, rebuilding" << std::endl;
+        return false;
+    }
+
+    SourceStamp current;
+    if (!ComputeStamp(mapPath, current, false)) return false;
+    if (current.size != stored.size) {
+        std::cout << "Map cache: " << mapPath << " changed, rebuilding" << std::endl;
+        return false;
+    }
+    if (current.modTime != stored.modTime) {
+        // Touched but maybe not edited (checkout, copy): compare contents
+        if (!ComputeStamp(mapPath, current, true) || current.hash != stored.hash) {
+            std::cout << "Map cache: " << mapPath << " changed, rebuilding" << std::endl;
+            return false;
+        }
+    }
+
+    uint32_t dependencyCount = 0;
+    reader.Read(dependencyCount);
+    for (uint32_t i = 0; i < dependencyCount && reader.Good(); ++i) {
+        std::string path;
+        SourceStamp dependency, now;
+        reader.ReadString(path);
+        reader.Read(dependency.size);
+        reader.Read(dependency.modTime);
+        ComputeStamp(path, now, false);
+        if (reader.Good() && (now.size != dependency.size || now.modTime != dependency.modTime)) {
+            std::cout << "Map cache: " << path << " changed, rebuilding" << std::endl;
+            return false;
+        }
+    }
+
+    // Map and tilesets
+    TMJMap loaded;
+    reader.Read(loaded.width);
+    reader.Read(loaded.height);
+    reader.Read(loaded.tileWidth);
+    reader.Read(loaded.tileHeight);
+
+    uint32_t tilesetCount = 0;
+    reader.Read(tilesetCount);
+    for (uint32_t i = 0; i < tilesetCount && reader.Good(); ++i) {
+        TileSet tileset{};
+        reader.Read(tileset.firstGid);
+        reader.Read(tileset.tileCount);
+        reader.Read(tileset.tileWidth);
+        reader.Read(tileset.tileHeight);
+        reader.Read(tileset.columns);
+        reader.Read(tileset.isAtlas);
+        reader.Read(tileset.tileOffsetX);
+        reader.Read(tileset.tileOffsetY);
+        reader.ReadString(tileset.sourcePath);
+        reader.ReadString(tileset.imagePath);
+
+        uint32_t imageCount = 0;
+        reader.Read(imageCount);
+        for (uint32_t j = 0; j < imageCount && reader.Good(); ++j) {
+            int localId = 0;
+            reader.Read(localId);
+            reader.ReadString(tileset.tileImagePaths[localId]);
+        }
+        loaded.tilesets.push_back(std::move(tileset));
+    }
+
+    // Layers
+    uint32_t layerCount = 0;
+    reader.Read(layerCount);
+    for (uint32_t i = 0; i < layerCount && reader.Good(); ++i) {
+        TileLayer layer;
+        reader.Read(layer.width);
+        reader.Read(layer.height);
+        reader.Read(layer.group);
+        reader.ReadVector(layer.data);
+        loaded.layers.push_back(std::move(layer));
+    }
+
+    // Collision templates and GID table
+    reader.ReadVector(loaded.tileCollisions.byGid);
+    uint32_t shapeCount = 0;
+    reader.Read(shapeCount);
+    for (uint32_t i = 0; i < shapeCount && reader.Good(); ++i) {
+        CollisionShape shape;
+        reader.Read(shape.type);
+        reader.Read(shape.rect);
+        reader.ReadVector(shape.points);
+        loaded.tileCollisions.shapes.push_back(std::move(shape));
+    }
+    reader.ReadVector(loaded.gidLookup);
+
+    // Generated tiles
+    TileGrid grid;
+    std::vector<int32_t> gridTilesets;
+    reader.Read(grid.layerCount);
+    reader.Read(grid.columns);
+    reader.Read(grid.rows);
+    reader.Read(grid.cellWidth);
+    reader.Read(grid.cellHeight);
+    reader.Read(grid.margin);
+    reader.ReadVector(grid.cellStart);
+    ReadTiles(reader, grid.tiles, gridTilesets);
+
+    std::vector<Tile> objects;
+    std::vector<int32_t> objectTilesets;
+    SpriteIndex index;
+    ReadTiles(reader, objects, objectTilesets);
+    reader.Read(index.columns);
+    reader.Read(index.rows);
+    reader.Read(index.cellWidth);
+    reader.Read(index.cellHeight);
+    reader.ReadVector(index.cellStart);
+    reader.ReadVector(index.cellItems);
+
+    // Baked collisions
+    CollisionWorld world;
+    CollisionStore& store = world.store;
+    reader.ReadVector(store.minX);
+    reader.ReadVector(store.minY);
+    reader.ReadVector(store.maxX);
+    reader.ReadVector(store.maxY);
+    reader.ReadVector(store.kind);
+    reader.ReadVector(store.invRadiusX);
+    reader.ReadVector(store.invRadiusY);
+    reader.ReadVector(store.firstPoint);
+    reader.ReadVector(store.pointCount);
+    reader.ReadVector(store.points);
+    reader.ReadVector(store.edgeNormals);
+    reader.ReadVector(store.projMin);
+    reader.ReadVector(store.projMax);
+
+    reader.Read(world.grid.cellWidth);
+    reader.Read(world.grid.cellHeight);
+    reader.Read(world.grid.columns);
+    reader.Read(world.grid.rows);
+    reader.ReadVector(world.grid.cellStart);
+    reader.ReadVector(world.grid.cellItems);
+    reader.ReadVector(world.grid.itemMinX);
+    reader.ReadVector(world.grid.itemMinY);
+    reader.ReadVector(world.grid.itemMaxX);
+    reader.ReadVector(world.grid.itemMaxY);
+    reader.Read(world.stats);
+
+    if (!reader.Good()) {
+        std::cerr << "Warning: Map cache " << cachePath << " is truncated, rebuilding" << std::endl;
+        return false;
+    }
+    if (!IsConsistent(loaded, grid, objects, index, world)) {
+        std::cerr << "Warning: Map cache " << cachePath << " is inconsistent, rebuilding" << std::endl;
+        return false;
+    }
+
+    // Commit, then resolve textures and re-link the tiles to the final tilesets
+    map = std::move(loaded);
+    MapLoader::LoadTilesetTextures(map);
+
+    backgroundTiles = std::move(grid);
+    LinkTiles(backgroundTiles.tiles, gridTilesets, map);
+    objectTiles = std::move(objects);
+    LinkTiles(objectTiles, objectTilesets, map);
+    objectIndex = std::move(index);
+    collisions = std::move(world);
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Map loaded from cache: " << map.width << "x" << map.height
+              << " (" << cachePath << ", " << std::fixed << std::setprecision(1) << elapsed << " ms)"
+              << std::defaultfloat << std::endl;
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TMJTypes.h"
+
+//==============================================================================
+// MAP CACHE
+//==============================================================================
+// Baked binary copy of a loaded map, written next to the source as
+// "<map>.bake". It holds the map header, tileset table, layer arrays,
+// collision templates and the results of tile and collision generation, so
+// an up-to-date cache is loaded with one mmap and a few memcpy's instead of
+// a JSON parse and a full bake.
+//
+// The cache is rejected when its version or struct layout differs, when the
+// source map changed (size and mtime, then a content hash when the mtime
+// alone differs) or when any external tileset or tileset image changed size
+// or mtime. It is also rejected when its arrays disagree with each other
+// (CSR offsets, shape and point ranges, tileset indices), so a corrupted
+// file is rebuilt rather than indexed out of bounds.
+// Textures are never stored: they are resolved again from the image paths.
+// Infinite maps are not cached.
+class MapCache {
+public:
+    static constexpr uint32_t VERSION = 3;
+
+    static std::string GetCachePath(const std::string& mapPath);
+
+    static bool Load(const std::string& mapPath, TMJMap& map, TileGrid& backgroundTiles,
+                     std::vector<Tile>& objectTiles, SpriteIndex& objectIndex, CollisionWorld& collisions);
+    static bool Save(const std::string& mapPath, const TMJMap& map, const TileGrid& backgroundTiles,
+                     const std::vector<Tile>& objectTiles, const SpriteIndex& objectIndex,
+                     const CollisionWorld& collisions);
+
+private:
+    struct SourceStamp {
+        uint64_t size = 0;
+        int64_t modTime = 0;
+        uint64_t hash = 0;
+    };
+
+    static bool ComputeStamp(const std::string& path, SourceStamp& stamp, bool withHash);
+    static uint64_t HashBytes(const unsigned char* data, size_t size);
+};
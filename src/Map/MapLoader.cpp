@@ -1,88 +1,302 @@
 #include "MapLoader.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+    //--------------------------------------------------------------------------
+    // Byte iterator for json::sax_parse that publishes how far the parser got
+    // every PROGRESS_STEP bytes, for the loading screen
+    //--------------------------------------------------------------------------
+    class ProgressIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = unsigned char;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const unsigned char*;
+        using reference = const unsigned char&;
+
+        static constexpr std::ptrdiff_t PROGRESS_STEP = 64 * 1024;
+
+        ProgressIterator(const unsigned char* cursor, const unsigned char* begin, LoadProgress* progress)
+            : m_cursor(cursor), m_begin(begin), m_progress(progress) {}
+
+        reference operator*() const { return *m_cursor; }
+
+        ProgressIterator& operator++() {
+            ++m_cursor;
+            if (((m_cursor - m_begin) & (PROGRESS_STEP - 1)) == 0) {
+                m_progress->bytesParsed.store((size_t)(m_cursor - m_begin), std::memory_order_relaxed);
+            }
+            return *this;
+        }
+
+        ProgressIterator operator++(int) {
+            ProgressIterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const ProgressIterator& other) const { return m_cursor == other.m_cursor; }
+        bool operator!=(const ProgressIterator& other) const { return m_cursor != other.m_cursor; }
+
+    private:
+        const unsigned char* m_cursor;
+        const unsigned char* m_begin;
+        LoadProgress* m_progress;
+    };
+}
 
 //==============================================================================
-// PARSE LAYERS
+// PARSE TILESET
 //==============================================================================
-void MapLoader::ParseLayers(const json& layerNode, TMJMap& map, bool isBackground) {
-    if (!layerNode.contains("type")) return;
+// Required keys are read with at(): a missing or mistyped one throws a
+// json::exception, caught by ParseTMJ, instead of reading past the object
+void MapLoader::ParseTileset(const json& ts, TMJMap& map, const std::string& baseDir) {
+    // External tilesets (.tsj) are not resolved by the TMJ loader
+    if (ts.contains("source")) {
+        std::cerr << "Error: External tileset " << ts["source"].dump() << " (firstgid "
+                  << ts.value("firstgid", 0) << ") is not supported in TMJ maps, embed it in the map; "
+                  << "its tiles will not be drawn" << std::endl;
+        return;
+    }
 
-    std::string type = layerNode["type"].get<std::string>();
+    TileSet tileset{};
+    tileset.firstGid = ts.at("firstgid").get<int>();
+    tileset.tileCount = ts.value("tilecount", 0);
+    tileset.tileWidth = ts.at("tilewidth").get<int>();
+    tileset.tileHeight = ts.at("tileheight").get<int>();
+
+    tileset.columns = 1;
+    if (ts.contains("columns")) {
+        int cols = 0;
+        try {
+            cols = ts["columns"].get<int>();
+        } catch (...) {
+            cols = 0;
+        }
+        if (cols > 0) tileset.columns = cols;
+    }
 
-    if (type == "group") {
-        std::string groupName = layerNode.value("name", "");
-        bool inBackground = (groupName == "Background" || isBackground);
+    if (ts.contains("tileoffset")) {
+        tileset.tileOffsetX = ts["tileoffset"].value("x", 0);
+        tileset.tileOffsetY = ts["tileoffset"].value("y", 0);
+    }
 
-        if (layerNode.contains("layers")) {
-            for (auto& subLayer : layerNode["layers"]) {
-                ParseLayers(subLayer, map, inBackground);
+    if (ts.contains("image")) {
+        tileset.isAtlas = true;
+        std::string imageRel = ts["image"].get<std::string>();
+        tileset.imagePath = FileUtils::ResolvePath(baseDir, imageRel);
+    } else {
+        tileset.isAtlas = false;
+        if (ts.contains("tiles")) {
+            for (auto& tileJson : ts["tiles"]) {
+                if (!tileJson.contains("id") || !tileJson.contains("image")) continue;
+
+                int localId = tileJson["id"].get<int>();
+                std::string imgRel = tileJson["image"].get<std::string>();
+                tileset.tileImagePaths[localId] = FileUtils::ResolvePath(baseDir, imgRel);
             }
         }
     }
-    else if (type == "tilelayer") {
-        TileLayer layer;
-        layer.width = layerNode["width"].get<int>();
-        layer.height = layerNode["height"].get<int>();
-        layer.data = layerNode["data"].get<std::vector<int>>();
 
-        if (isBackground) {
-            map.backgroundLayers.push_back(layer);
-        } else {
-            map.otherLayers.push_back(layer);
-        }
-    }
+    ParseTileCollisions(ts, tileset, map);
+    map.tilesets.push_back(std::move(tileset));
 }
 
 //==============================================================================
-// PARSE TILESETS
+// TILESET TEXTURES
 //==============================================================================
-void MapLoader::ParseTilesets(const json& data, TMJMap& map, const std::string& baseDir) {
-    auto& resourceMgr = ResourceManager::GetInstance();
+// Resolves the textures of every tileset from its image paths. Images are
+// decoded in parallel and packed off the main thread; only the GPU upload goes
+// through the main thread, so this is safe to call from a loading thread.
+void MapLoader::LoadTilesetTextures(TMJMap& map) {
+    TilesetImages images = DecodeTilesetImages(map);
+    MainThread::Invoke([&] { UploadTilesetImages(map, images); });
+}
 
-    for (auto& ts : data["tilesets"]) {
-        TileSet tileset{};
-        tileset.firstGid = ts["firstgid"].get<int>();
-        tileset.tileWidth = ts["tilewidth"].get<int>();
-        tileset.tileHeight = ts["tileheight"].get<int>();
-
-        tileset.columns = 1;
-        if (ts.contains("columns")) {
-            int cols = 0;
-            try {
-                cols = ts["columns"].get<int>();
-            } catch (...) {
-                cols = 0;
+MapLoader::TilesetImages MapLoader::DecodeTilesetImages(TMJMap& map) {
+    TilesetImages images;
+    images.atlases.resize(map.tilesets.size());
+
+    // One image per distinct file, shared by every tile that uses it
+    std::vector<std::string>& paths = images.collectionPaths;
+    for (const auto& tileset : map.tilesets) {
+        for (const auto& [localId, path] : tileset.tileImagePaths) {
+            if (images.collectionIndex.emplace(path, (int)paths.size()).second) {
+                paths.push_back(path);
             }
-            if (cols > 0) tileset.columns = cols;
         }
+    }
 
-        if (ts.contains("tileoffset")) {
-            tileset.tileOffsetX = ts["tileoffset"].value("x", 0);
-            tileset.tileOffsetY = ts["tileoffset"].value("y", 0);
+    // Atlases and collection images are decoded as one parallel batch
+    std::vector<std::string> files;
+    std::vector<int> atlasTilesets;
+    for (size_t i = 0; i < map.tilesets.size(); ++i) {
+        const TileSet& tileset = map.tilesets[i];
+        if (tileset.isAtlas && !tileset.imagePath.empty()) {
+            files.push_back(tileset.imagePath);
+            atlasTilesets.push_back((int)i);
         }
+    }
+    files.insert(files.end(), paths.begin(), paths.end());
 
-        if (ts.contains("image")) {
-            tileset.isAtlas = true;
-            std::string imageRel = ts["image"].get<std::string>();
-            std::string imageFull = FileUtils::ResolvePath(baseDir, imageRel);
-            Texture2D& tex = resourceMgr.LoadTextureCached(imageFull);
-            tileset.atlas = &tex;
-        } else {
-            tileset.isAtlas = false;
-            if (ts.contains("tiles")) {
-                for (auto& tileJson : ts["tiles"]) {
-                    if (!tileJson.contains("id") || !tileJson.contains("image")) continue;
-
-                    int localId = tileJson["id"].get<int>();
-                    std::string imgRel = tileJson["image"].get<std::string>();
-                    std::string imgFull = FileUtils::ResolvePath(baseDir, imgRel);
-                    Texture2D& tex = resourceMgr.LoadTextureCached(imgFull);
-                    tileset.tileImages[localId] = &tex;
-                }
-            }
+    std::vector<Image> decoded = ResourceManager::GetInstance().DecodeImages(files);
+    for (size_t i = 0; i < atlasTilesets.size(); ++i) {
+        images.atlases[atlasTilesets[i]] = decoded[i];
+    }
+    images.collectionImages.assign(decoded.begin() + atlasTilesets.size(), decoded.end());
+
+    PackImageCollections(map, images);
+    return images;
+}
+
+void MapLoader::UploadTilesetImages(TMJMap& map, TilesetImages& images) {
+    auto& resourceMgr = ResourceManager::GetInstance();
+
+    // Atlases and the collection images too large for a page go up as one
+    // batch; a failed atlas is cached empty so it is not retried
+    std::vector<std::string> files;
+    std::vector<Image> uploads;
+    std::vector<int> atlasTilesets;
+    for (size_t i = 0; i < map.tilesets.size(); ++i) {
+        const TileSet& tileset = map.tilesets[i];
+        if (tileset.isAtlas && !tileset.imagePath.empty()) {
+            files.push_back(tileset.imagePath);
+            uploads.push_back(images.atlases[i]);
+            atlasTilesets.push_back((int)i);
+        }
+        images.atlases[i] = Image{};
+    }
+
+    std::vector<int> standalone;
+    for (size_t i = 0; i < images.collectionPaths.size(); ++i) {
+        if (images.collectionPages[i] < 0 && images.collectionImages[i].data) {
+            files.push_back(images.collectionPaths[i]);
+            uploads.push_back(images.collectionImages[i]);
+            standalone.push_back((int)i);
+        }
+        images.collectionImages[i] = Image{};
+    }
+
+    std::vector<TextureHandle> uploaded = resourceMgr.UploadImages(files, uploads);
+    map.textures.insert(map.textures.end(), uploaded.begin(), uploaded.end());
+    for (size_t i = 0; i < atlasTilesets.size(); ++i) {
+        map.tilesets[atlasTilesets[i]].atlas = uploaded[i];
+    }
+
+    static int s_atlasCount = 0;
+    std::vector<TextureHandle> pageTextures(images.pages.size());
+    for (size_t page = 0; page < images.pages.size(); ++page) {
+        std::string name = "atlas#" + std::to_string(s_atlasCount++);
+        pageTextures[page] = resourceMgr.RegisterTexture(name, LoadTextureFromImage(images.pages[page]));
+        map.textures.push_back(pageTextures[page]);
+        UnloadImage(images.pages[page]);
+    }
+
+    std::vector<TextureHandle> textures(images.collectionPaths.size());
+    for (size_t i = 0; i < images.collectionPaths.size(); ++i) {
+        if (images.collectionPages[i] >= 0) {
+            textures[i] = pageTextures[images.collectionPages[i]];
+        }
+    }
+    for (size_t i = 0; i < standalone.size(); ++i) {
+        textures[standalone[i]] = uploaded[atlasTilesets.size() + i];
+    }
+
+    for (auto& tileset : map.tilesets) {
+        tileset.tileImages.clear();
+        for (const auto& [localId, path] : tileset.tileImagePaths) {
+            TextureHandle texture = textures[images.collectionIndex[path]];
+            if (texture.IsValid()) tileset.tileImages[localId] = texture;
+        }
+    }
+
+    if (!images.collectionPaths.empty()) {
+        std::cout << "Image atlas: " << images.collectionPaths.size() << " images packed into "
+                  << pageTextures.size() << " page(s)" << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Releases the map's texture references and clears it. Textures still used
+// by another map or by the player stay loaded. Returns the VRAM freed.
+size_t MapLoader::UnloadMap(TMJMap& map) {
+    auto& resourceMgr = ResourceManager::GetInstance();
+
+    size_t freedBytes = 0;
+    int freedCount = 0;
+    for (TextureHandle handle : map.textures) {
+        freedBytes += resourceMgr.ReleaseTexture(handle);
+        if (!resourceMgr.IsValid(handle)) freedCount++;
+    }
+
+    std::cout << "Map unloaded: " << freedCount << "/" << map.textures.size() << " textures released, "
+              << MemoryUtils::FormatBytes(freedBytes) << " VRAM freed" << std::endl;
+
+    map = TMJMap{};
+    return freedBytes;
+}
+
+//==============================================================================
+// PACK IMAGE COLLECTIONS
+//==============================================================================
+// Image-collection tiles are packed into shared atlas pages so object layers
+// draw from one or a few textures. Images too large for a page keep their
+// own texture.
+void MapLoader::PackImageCollections(TMJMap& map, TilesetImages& images) {
+    const std::vector<std::string>& paths = images.collectionPaths;
+    if (paths.empty()) return;
+
+    std::vector<Image>& loaded = images.collectionImages;
+    std::vector<AtlasPacker::Size> sizes(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        sizes[i] = {loaded[i].width, loaded[i].height};
+        if (!loaded[i].data) {
+            std::cerr << "Warning: Unable to load tile image " << paths[i] << std::endl;
+        }
+    }
+
+    AtlasPacker packer(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, ATLAS_PADDING);
+    std::vector<AtlasPacker::Placement> placements = packer.Pack(sizes);
+
+    // Pages are trimmed to the area actually used
+    images.pages.resize(packer.GetPageCount());
+    for (int page = 0; page < packer.GetPageCount(); ++page) {
+        AtlasPacker::Size used = packer.GetUsedSize(page);
+        images.pages[page] = GenImageColor(used.width, used.height, BLANK);
+    }
+
+    // Packed images are drawn into their page and released; the others are
+    // kept for their own upload
+    images.collectionPages.assign(paths.size(), -1);
+    std::vector<Rectangle> rects(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        Image& image = loaded[i];
+        if (!image.data) continue;
+
+        Rectangle full = {0, 0, (float)image.width, (float)image.height};
+        if (placements[i].page < 0) {
+            rects[i] = full;
+            continue;
         }
 
-        ParseTileCollisions(ts, tileset, map);
-        map.tilesets.push_back(tileset);
+        rects[i] = {(float)placements[i].x, (float)placements[i].y, full.width, full.height};
+        ImageDraw(&images.pages[placements[i].page], image, full, rects[i], WHITE);
+        images.collectionPages[i] = placements[i].page;
+        UnloadImage(image);
+        image = Image{};
+    }
+
+    for (auto& tileset : map.tilesets) {
+        tileset.tileRects.clear();
+        for (const auto& [localId, path] : tileset.tileImagePaths) {
+            int index = images.collectionIndex[path];
+            if (images.collectionPages[index] >= 0 || loaded[index].data) {
+                tileset.tileRects[localId] = rects[index];
+            }
+        }
     }
 }
 
@@ -98,107 +312,450 @@ void MapLoader::ParseTileCollisions(const json& tilesetJson, const TileSet& tile
         int localId = tileJson["id"].get<int>();
         int globalId = tileset.firstGid + localId;
 
-        if (!tileJson.contains("objectgroup")) continue;
+        if (!tileJson.contains("objectgroup") || !tileJson["objectgroup"].contains("objects") ||
+            globalId < 0) continue;
 
-        std::vector<CollisionShape> shapes;
+        const int first = (int)map.tileCollisions.shapes.size();
 
         for (auto& obj : tileJson["objectgroup"]["objects"]) {
             CollisionShape shape{};
 
-            if (obj.contains("polygon")) {
-                shape.type = ShapeType::Polygon;
-                for (auto& p : obj["polygon"]) {
-                    shape.points.push_back({(float)p["x"], (float)p["y"]});
-                }
-            }
-            else if (obj.contains("polyline")) {
-                shape.type = ShapeType::Polyline;
-                for (auto& p : obj["polyline"]) {
-                    shape.points.push_back({(float)p["x"], (float)p["y"]});
+            // Polygon and polyline points are relative to the object origin
+            float originX = obj.value("x", 0.0f);
+            float originY = obj.value("y", 0.0f);
+
+            if (obj.contains("polygon") || obj.contains("polyline")) {
+                bool closed = obj.contains("polygon");
+                shape.type = closed ? ShapeType::Polygon : ShapeType::Polyline;
+                for (auto& p : obj[closed ? "polygon" : "polyline"]) {
+                    shape.points.push_back({originX + p.value("x", 0.0f), originY + p.value("y", 0.0f)});
                 }
             }
-            else if (obj.contains("ellipse") && obj["ellipse"].get<bool>()) {
+            else if (obj.value("ellipse", false) && obj.contains("width") && obj.contains("height")) {
                 shape.type = ShapeType::Ellipse;
-                shape.rect = {
-                    (float)obj["x"], (float)obj["y"],
-                    (float)obj["width"], (float)obj["height"]
-                };
+                shape.rect = {originX, originY, (float)obj["width"], (float)obj["height"]};
             }
             else if (obj.contains("width") && obj.contains("height")) {
                 shape.type = ShapeType::Rectangle;
-                shape.rect = {
-                    (float)obj["x"], (float)obj["y"],
-                    (float)obj["width"], (float)obj["height"]
-                };
+                shape.rect = {originX, originY, (float)obj["width"], (float)obj["height"]};
             }
             else {
                 shape.type = ShapeType::Unknown;
             }
 
-            shapes.push_back(shape);
+            AddCollisionShape(map, globalId, std::move(shape));
         }
 
-        if (!shapes.empty()) {
-            map.tileCollisions[globalId] = shapes;
+        SetTileCollisions(map, globalId, first);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Shared by the TMJ and TMX parsers: concave polygons are split into convex
+// pieces for SAT and polylines are simplified
+void MapLoader::AddCollisionShape(TMJMap& map, int globalId, CollisionShape shape) {
+    std::vector<CollisionShape>& shapes = map.tileCollisions.shapes;
+
+    if (shape.type == ShapeType::Polygon) {
+        bool approximated = false;
+        auto pieces = ConvexDecomposition::Decompose(shape.points, approximated);
+        if (approximated) {
+            std::cerr << "Warning: Collision polygon of tile " << globalId << " (" << shape.points.size()
+                      << " points) is self-intersecting, its unsplit part collides as its convex hull" << std::endl;
         }
+        for (auto& piece : pieces) {
+            CollisionShape convex{};
+            convex.type = ShapeType::Polygon;
+            convex.points = std::move(piece);
+            shapes.push_back(std::move(convex));
+        }
+        return;
+    }
+
+    if (shape.type == ShapeType::Polyline) {
+        shape.points = ConvexDecomposition::Simplify(shape.points, false);
+    }
+    shapes.push_back(std::move(shape));
+}
+
+// Records the shapes added since `first` as the collisions of a GID
+void MapLoader::SetTileCollisions(TMJMap& map, int globalId, int first) {
+    const int count = (int)map.tileCollisions.shapes.size() - first;
+    if (count <= 0 || globalId < 0) return;
+
+    auto& byGid = map.tileCollisions.byGid;
+    if (globalId >= (int)byGid.size()) {
+        byGid.resize(globalId + 1);
     }
+    byGid[globalId] = {first, count};
 }
 
 //==============================================================================
-// LOAD MAP
+// ENCODED LAYER DATA
 //==============================================================================
-TMJMap MapLoader::LoadMap(const std::string& tmjPath) {
-    TMJMap map;
+// Shared by the TMJ and TMX parsers: base64 text, optionally compressed, of
+// little-endian 32-bit GIDs. Decompression writes straight into `data`, sized
+// to tileCount (a layer or an infinite map chunk).
+bool MapLoader::DecodeLayerData(const char* text, size_t length, const std::string& compression,
+                                size_t tileCount, std::vector<int>& data) {
+    std::vector<unsigned char> bytes;
+    if (!Compression::DecodeBase64(text, length, bytes)) {
+        std::cerr << "Error: Invalid base64 layer data" << std::endl;
+        return false;
+    }
 
-    std::ifstream file(tmjPath);
-    if (!file.is_open()) {
-        std::cerr << "Error: Unable to open " << tmjPath << std::endl;
-        return map;
+    size_t expectedBytes = tileCount * sizeof(uint32_t);
+    data.assign(tileCount, 0);
+    unsigned char* output = reinterpret_cast<unsigned char*>(data.data());
+    size_t written = 0;
+    bool decoded = false;
+
+    if (compression.empty()) {
+        written = std::min(bytes.size(), expectedBytes);
+        if (written > 0) std::memcpy(output, bytes.data(), written);
+        decoded = true;
+    }
+    else if (compression == "zlib") {
+        decoded = Compression::Inflate(bytes.data(), bytes.size(), Compression::Container::Zlib, output, expectedBytes, written);
+    }
+    else if (compression == "gzip") {
+        decoded = Compression::Inflate(bytes.data(), bytes.size(), Compression::Container::Gzip, output, expectedBytes, written);
+    }
+    else if (compression == "zstd") {
+        if (!Compression::HasZstd()) {
+            std::cerr << "Error: zstd layer data requires a build with USE_ZSTD=1" << std::endl;
+            data.clear();
+            return false;
+        }
+        decoded = Compression::DecompressZstd(bytes.data(), bytes.size(), output, expectedBytes, written);
+    }
+    else {
+        std::cerr << "Error: Unknown layer compression '" << compression << "'" << std::endl;
+        data.clear();
+        return false;
+    }
+
+    if (!decoded) {
+        std::cerr << "Error: Failed to decompress " << compression << " layer data" << std::endl;
+        data.clear();
+        return false;
+    }
+    if (written != expectedBytes) {
+        std::cerr << "Warning: Layer data holds " << written / sizeof(uint32_t) << " tiles, expected "
+                  << tileCount << std::endl;
+    }
+
+    // GIDs are stored little-endian; swap in place on big-endian hosts
+    const uint32_t probe = 1;
+    if (*reinterpret_cast<const unsigned char*>(&probe) == 0) {
+        for (int& gid : data) {
+            uint32_t value = (uint32_t)gid;
+            gid = (int)((value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24));
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Tile data must hold exactly width * height GIDs: TileGenerator and
+// CollisionSystem index data[y * width + x] without bounds checks. Short data
+// is padded with empty tiles, extra data dropped.
+//------------------------------------------------------------------------------
+void MapLoader::FitLayerData(std::vector<int>& data, size_t tileCount, const std::string& name) {
+    if (data.size() == tileCount) return;
+
+    std::cerr << "Warning: " << name << " holds " << data.size() << " tiles, expected " << tileCount
+              << (data.size() < tileCount ? ", missing tiles left empty" : ", extra tiles dropped") << std::endl;
+    data.resize(tileCount, 0);
+}
+
+//==============================================================================
+// INFINITE MAP CHUNKS
+//==============================================================================
+// Tiled writes every chunk of a map with the same size and aligned on it, so
+// the size of the first chunk defines the chunk grid
+void MapLoader::AddLayerChunk(TMJMap& map, TileLayer& layer, LayerChunk chunk) {
+    if (chunk.width <= 0 || chunk.height <= 0) return;
+
+    if (map.chunkWidth == 0) {
+        map.chunkWidth = chunk.width;
+        map.chunkHeight = chunk.height;
+    }
+    if (chunk.width != map.chunkWidth || chunk.height != map.chunkHeight ||
+        chunk.x % map.chunkWidth != 0 || chunk.y % map.chunkHeight != 0) {
+        std::cerr << "Warning: Chunk at " << chunk.x << "," << chunk.y
+                  << " is not aligned on the map's chunk grid, skipped" << std::endl;
+        return;
+    }
+
+    // Decoded chunks are packed so every chunk can leave memory when streamed out
+    if (chunk.encoded.empty() && !chunk.data.empty()) {
+        FitLayerData(chunk.data, (size_t)chunk.width * chunk.height,
+                     "Chunk at " + std::to_string(chunk.x) + "," + std::to_string(chunk.y));
+        PackChunkData(chunk.data, chunk.packed);
+        std::vector<int>().swap(chunk.data);
     }
 
-    json data;
-    file >> data;
+    long long key = GetChunkKey(chunk.x / map.chunkWidth, chunk.y / map.chunkHeight);
+    layer.chunks[key] = std::move(chunk);
+}
 
-    const std::string baseDir = FileUtils::GetDirectoryName(tmjPath);
+//------------------------------------------------------------------------------
+// Runs of equal GIDs as (length, gid) pairs of LEB128 varints: empty and
+// filled areas, the bulk of most chunks, shrink to a few bytes
+void MapLoader::PackChunkData(const std::vector<int>& data, std::vector<unsigned char>& packed) {
+    auto writeVarint = [&](uint32_t value) {
+        while (value >= 0x80) {
+            packed.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        packed.push_back((unsigned char)value);
+    };
+
+    packed.clear();
+    for (size_t i = 0; i < data.size();) {
+        size_t run = 1;
+        while (i + run < data.size() && data[i + run] == data[i]) run++;
+        writeVarint((uint32_t)run);
+        writeVarint((uint32_t)data[i]);
+        i += run;
+    }
+    packed.shrink_to_fit();
+}
 
-    map.width = data["width"].get<int>();
-    map.height = data["height"].get<int>();
-    map.tileWidth = data["tilewidth"].get<int>();
-    map.tileHeight = data["tileheight"].get<int>();
+bool MapLoader::UnpackChunkData(const std::vector<unsigned char>& packed, size_t tileCount, std::vector<int>& data) {
+    size_t pos = 0;
+    auto readVarint = [&](uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35 && pos < packed.size(); shift += 7) {
+            unsigned char byte = packed[pos++];
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    };
+
+    data.clear();
+    data.reserve(tileCount);
+    while (pos < packed.size()) {
+        uint32_t run = 0, gid = 0;
+        if (!readVarint(run) || !readVarint(gid) || run > tileCount - data.size()) return false;
+        data.insert(data.end(), run, (int)gid);
+    }
+    return data.size() == tileCount;
+}
 
-    ParseTilesets(data, map, baseDir);
+long long MapLoader::GetChunkKey(int chunkX, int chunkY) {
+    return (long long)(((unsigned long long)(unsigned int)chunkY << 32) | (unsigned int)chunkX);
+}
+
+// World area covered by the map in pixels: the layer size for finite maps,
+// the union of every chunk for infinite ones
+Rectangle MapLoader::GetWorldBounds(const TMJMap& map) {
+    if (!map.infinite) {
+        return {0.0f, 0.0f, (float)(map.width * map.tileWidth), (float)(map.height * map.tileHeight)};
+    }
 
-    if (data.contains("layers")) {
-        for (auto& layer : data["layers"]) {
-            ParseLayers(layer, map);
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool any = false;
+    for (const auto& layer : map.layers) {
+        for (const auto& [key, chunk] : layer.chunks) {
+            if (!any) {
+                minX = chunk.x;
+                minY = chunk.y;
+                maxX = chunk.x + chunk.width;
+                maxY = chunk.y + chunk.height;
+                any = true;
+                continue;
+            }
+            minX = std::min(minX, chunk.x);
+            minY = std::min(minY, chunk.y);
+            maxX = std::max(maxX, chunk.x + chunk.width);
+            maxY = std::max(maxY, chunk.y + chunk.height);
         }
     }
 
-    size_t totalCollisions = 0;
-    for (const auto& [gid, shapes] : map.tileCollisions) {
-        totalCollisions += shapes.size();
+    return {
+        (float)(minX * map.tileWidth), (float)(minY * map.tileHeight),
+        (float)((maxX - minX) * map.tileWidth), (float)((maxY - minY) * map.tileHeight)
+    };
+}
+
+//==============================================================================
+// LOAD MAP
+//==============================================================================
+bool MapLoader::ParseTMJ(const std::string& tmjPath, TMJMap& map, LoadProgress* progress) {
+    MappedFile file;
+    if (!file.Open(tmjPath)) {
+        std::cerr << "Error: Unable to open " << tmjPath << std::endl;
+        return false;
     }
 
-    std::cout << "Map loaded: " << map.width << "x" << map.height << std::endl;
+    // Streamed straight from the mapped file, no DOM of the whole map
+    TMJStreamParser parser(map, FileUtils::GetDirectoryName(tmjPath), progress);
+    const unsigned char* data = file.GetData();
+    const unsigned char* end = data + file.GetSize();
+
+    // Malformed content (missing keys, wrong types) throws from the handlers;
+    // it must not escape, the parse may run on the loading thread
+    bool parsed;
+    try {
+        if (progress) {
+            progress->bytesTotal = file.GetSize();
+            parsed = json::sax_parse(ProgressIterator(data, data, progress), ProgressIterator(end, data, progress), &parser);
+            progress->bytesParsed = file.GetSize();
+        } else {
+            parsed = json::sax_parse(data, end, &parser);
+        }
+    } catch (const json::exception& e) {
+        std::cerr << "Error: Invalid map " << tmjPath << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    if (!parsed) {
+        std::cerr << "Error: Unable to parse " << tmjPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+// .tmx maps go through the XML loader, anything else is read as TMJ
+// A map that cannot be read or parsed leaves `map` empty and returns false
+bool MapLoader::LoadMap(const std::string& mapPath, TMJMap& map, LoadProgress* progress) {
+    map = TMJMap{};
+
+    if (progress) progress->stage = LoadStage::Parsing;
+    bool parsed = FileUtils::HasExtension(mapPath, ".tmx") ? TMXLoader::Parse(mapPath, map, progress)
+                                                           : ParseTMJ(mapPath, map, progress);
+    if (!parsed) {
+        map = TMJMap{};
+        return false;
+    }
+
+    if (progress) progress->stage = LoadStage::Textures;
+    LoadTilesetTextures(map);
+    BuildGidLookup(map);
+
+    size_t totalCollisions = map.tileCollisions.shapes.size();
+
+    if (map.infinite) {
+        size_t chunkCount = 0;
+        for (const auto& layer : map.layers) chunkCount += layer.chunks.size();
+        std::cout << "Map loaded: infinite, " << chunkCount << " chunks of "
+                  << map.chunkWidth << "x" << map.chunkHeight << std::endl;
+    } else {
+        std::cout << "Map loaded: " << map.width << "x" << map.height << std::endl;
+    }
     std::cout << "Tilesets: " << map.tilesets.size() << std::endl;
     std::cout << "Collision definitions: " << totalCollisions << std::endl;
-    std::cout << "Background layers: " << map.backgroundLayers.size() << std::endl;
-    std::cout << "Object layers: " << map.otherLayers.size() << std::endl;
+    std::cout << "Background layers: " << GetLayers(map, LayerGroup::Background).size() << std::endl;
+    std::cout << "Object layers: " << GetLayers(map, LayerGroup::Objects).size() << std::endl;
 
-    return map;
+    return true;
+}
+
+//==============================================================================
+// LAYER VIEWS
+//==============================================================================
+LayerView MapLoader::GetLayers(const TMJMap& map) {
+    LayerView view;
+    view.reserve(map.layers.size());
+    for (const auto& layer : map.layers) {
+        view.push_back(&layer);
+    }
+    return view;
+}
+
+LayerView MapLoader::GetLayers(const TMJMap& map, LayerGroup group) {
+    LayerView view;
+    for (const auto& layer : map.layers) {
+        if (layer.group == group) view.push_back(&layer);
+    }
+    return view;
+}
+
+//==============================================================================
+// GID LOOKUP
+//==============================================================================
+// Dense table indexed by GID covering every tileset range. Maps whose GID
+// space is too sparse for a table fall back to a binary search on firstGid.
+// Each tileset only owns [firstGid, firstGid + GetGidCount): GIDs of a
+// tileset that failed to load resolve to nothing rather than to the
+// tileset before it.
+static constexpr int MAX_DENSE_GIDS = 1 << 20;
+
+// Image collections keep the ids of removed tiles, so their ids can run past
+// tilecount. 0 when the tileset does not say: the range then extends to the
+// next tileset.
+int MapLoader::GetGidCount(const TileSet& tileset) {
+    int count = std::max(tileset.tileCount, 0);
+    if (!tileset.tileImagePaths.empty()) {
+        count = std::max(count, tileset.tileImagePaths.rbegin()->first + 1);
+    }
+    return count;
+}
+
+void MapLoader::BuildGidLookup(TMJMap& map) {
+    map.gidLookup.clear();
+    if (map.tilesets.empty()) return;
+
+    std::stable_sort(map.tilesets.begin(), map.tilesets.end(),
+        [](const TileSet& a, const TileSet& b) { return a.firstGid < b.firstGid; });
+
+    const int tilesetCount = (int)map.tilesets.size();
+    std::vector<int> ends(tilesetCount);
+    int maxGid = 0;
+    for (int index = 0; index < tilesetCount; ++index) {
+        const TileSet& tileset = map.tilesets[index];
+        int count = GetGidCount(tileset);
+        int next = (index + 1 < tilesetCount) ? map.tilesets[index + 1].firstGid : tileset.firstGid + std::max(count, 1);
+        ends[index] = (count > 0) ? std::min(tileset.firstGid + count, next) : next;
+        maxGid = std::max(maxGid, ends[index]);
+    }
+    if (maxGid > MAX_DENSE_GIDS) return;
+
+    map.gidLookup.resize(maxGid);
+    for (int index = 0; index < tilesetCount; ++index) {
+        const TileSet& tileset = map.tilesets[index];
+        for (int gid = std::max(tileset.firstGid, 0); gid < ends[index]; ++gid) {
+            map.gidLookup[gid] = {index, gid - tileset.firstGid};
+        }
+    }
+}
+
+int MapLoader::FindTilesetIndexForGID(const TMJMap& map, int gid) {
+    if (gid >= 0 && gid < (int)map.gidLookup.size()) {
+        return map.gidLookup[gid].tilesetIndex;
+    }
+
+    auto it = std::upper_bound(map.tilesets.begin(), map.tilesets.end(), gid,
+        [](int value, const TileSet& tileset) { return value < tileset.firstGid; });
+    if (it == map.tilesets.begin()) return -1;
+
+    int index = (int)(it - map.tilesets.begin()) - 1;
+    int count = GetGidCount(map.tilesets[index]);
+    if (count > 0 && gid >= map.tilesets[index].firstGid + count) return -1;
+    return index;
 }
 
 //==============================================================================
 // FIND TILESET FOR GID
 //==============================================================================
 const TileSet* MapLoader::FindTilesetForGID(const TMJMap& map, int gid) {
-    const TileSet* result = nullptr;
-    for (const auto& tileset : map.tilesets) {
-        if (gid >= tileset.firstGid) {
-            result = &tileset;
-        } else {
-            break;
-        }
+    int index = FindTilesetIndexForGID(map, gid);
+    return (index >= 0) ? &map.tilesets[index] : nullptr;
+}
+
+const TileSet* MapLoader::ResolveGID(const TMJMap& map, int gid, int& localId) {
+    if (gid >= 0 && gid < (int)map.gidLookup.size()) {
+        const GidEntry& entry = map.gidLookup[gid];
+        if (entry.tilesetIndex < 0) return nullptr;
+        localId = entry.localId;
+        return &map.tilesets[entry.tilesetIndex];
     }
-    return result;
+
+    const TileSet* tileset = FindTilesetForGID(map, gid);
+    if (tileset) localId = gid - tileset->firstGid;
+    return tileset;
 }
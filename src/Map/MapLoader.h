@@ -8,7 +8,15 @@
 
 #include "../Core/ResourceManager.h"
 #include "../Core/FileUtils.h"
+#include "../Core/AtlasPacker.h"
+#include "../Core/MappedFile.h"
+#include "../Core/Compression.h"
+#include "../Core/MainThread.h"
+#include "../Core/MemoryUtils.h"
 #include "TMJTypes.h"
+#include "ConvexDecomposition.h"
+#include "TMJStreamParser.h"
+#include "TMXLoader.h"
 
 using json = nlohmann::json;
 
@@ -17,11 +25,49 @@ using json = nlohmann::json;
 //==============================================================================
 class MapLoader {
 private:
-    static void ParseLayers(const json& layerNode, TMJMap& map, bool isBackground = false);
-    static void ParseTilesets(const json& data, TMJMap& map, const std::string& baseDir);
+    static constexpr int ATLAS_PAGE_SIZE = 2048;
+    static constexpr int ATLAS_PADDING = 2;
+
+    friend class TMJStreamParser;
+    friend class TMXLoader;
+    friend class ChunkStreamer;
+
+    static bool ParseTMJ(const std::string& tmjPath, TMJMap& map, LoadProgress* progress);
+    static void ParseTileset(const json& tilesetJson, TMJMap& map, const std::string& baseDir);
     static void ParseTileCollisions(const json& tilesetJson, const TileSet& tileset, TMJMap& map);
+    static void AddCollisionShape(TMJMap& map, int globalId, CollisionShape shape);
+    static void SetTileCollisions(TMJMap& map, int globalId, int first);
+    static bool DecodeLayerData(const char* text, size_t length, const std::string& compression,
+                                size_t tileCount, std::vector<int>& data);
+    static void FitLayerData(std::vector<int>& data, size_t tileCount, const std::string& name);
+    static void AddLayerChunk(TMJMap& map, TileLayer& layer, LayerChunk chunk);
+    static void PackChunkData(const std::vector<int>& data, std::vector<unsigned char>& packed);
+    static bool UnpackChunkData(const std::vector<unsigned char>& packed, size_t tileCount, std::vector<int>& data);
+    // Tileset images decoded on the loading thread, waiting for their upload
+    struct TilesetImages {
+        std::vector<Image> atlases;                   // by tileset, atlas tilesets only
+        std::vector<std::string> collectionPaths;     // distinct image-collection files
+        std::map<std::string, int> collectionIndex;
+        std::vector<int> collectionPages;             // atlas page of each file, -1 for its own texture
+        std::vector<Image> collectionImages;          // kept only for files with their own texture
+        std::vector<Image> pages;
+    };
+
+    static TilesetImages DecodeTilesetImages(TMJMap& map);
+    static void PackImageCollections(TMJMap& map, TilesetImages& images);
+    static void UploadTilesetImages(TMJMap& map, TilesetImages& images);
+    static void BuildGidLookup(TMJMap& map);
+    static int GetGidCount(const TileSet& tileset);
+    static int FindTilesetIndexForGID(const TMJMap& map, int gid);
 
 public:
-    static TMJMap LoadMap(const std::string& tmjPath);
+    static bool LoadMap(const std::string& mapPath, TMJMap& map, LoadProgress* progress = nullptr);
+    static void LoadTilesetTextures(TMJMap& map);
+    static size_t UnloadMap(TMJMap& map);
+    static LayerView GetLayers(const TMJMap& map);
+    static LayerView GetLayers(const TMJMap& map, LayerGroup group);
+    static Rectangle GetWorldBounds(const TMJMap& map);
+    static long long GetChunkKey(int chunkX, int chunkY);
     static const TileSet* FindTilesetForGID(const TMJMap& map, int gid);
+    static const TileSet* ResolveGID(const TMJMap& map, int gid, int& localId);
 };
@@ -0,0 +1,334 @@
+#include "TMJStreamParser.h"
+#include "MapLoader.h"
+#include <algorithm>
+#include <iostream>
+
+TMJStreamParser::TMJStreamParser(TMJMap& map, const std::string& baseDir, LoadProgress* progress)
+    : m_map(map), m_baseDir(baseDir), m_progress(progress) {}
+
+//==============================================================================
+// SCALARS
+//==============================================================================
+bool TMJStreamParser::null() {
+    return Value(nullptr);
+}
+
+bool TMJStreamParser::boolean(bool value) {
+    if (!m_contexts.empty() && m_contexts.back() == Context::Root && m_key == "infinite") {
+        m_map.infinite = value;
+    }
+    return Value(value);
+}
+
+bool TMJStreamParser::number_integer(json::number_integer_t value) {
+    return Integer(value);
+}
+
+bool TMJStreamParser::number_unsigned(json::number_unsigned_t value) {
+    return Integer((long long)value);
+}
+
+bool TMJStreamParser::number_float(json::number_float_t value, const json::string_t&) {
+    return Value(value);
+}
+
+bool TMJStreamParser::binary(json::binary_t&) {
+    return true;
+}
+
+bool TMJStreamParser::string(json::string_t& value) {
+    if (m_contexts.empty()) return true;
+
+    switch (m_contexts.back()) {
+        case Context::Capture:
+            AddDomValue(std::move(value));
+            break;
+
+        case Context::Layer:
+            if (m_key == "type") m_layers.back().type = std::move(value);
+            else if (m_key == "name") m_layers.back().name = std::move(value);
+            else if (m_key == "data") {
+                m_layers.back().encodedData = std::move(value);
+                m_layers.back().hasData = true;
+            }
+            else if (m_key == "encoding") m_layers.back().encoding = std::move(value);
+            else if (m_key == "compression") m_layers.back().compression = std::move(value);
+            break;
+
+        case Context::Chunk:
+            if (m_key == "data") m_layers.back().chunks.back().encoded = std::move(value);
+            break;
+
+        default:
+            break;
+    }
+    return true;
+}
+
+// Integers are the hot path: every GID of every tile layer
+bool TMJStreamParser::Integer(long long value) {
+    if (m_contexts.empty()) return true;
+
+    switch (m_contexts.back()) {
+        case Context::LayerData:
+            // GIDs carry flip flags in their high bits: keep the 32-bit pattern
+            m_layers.back().layer.data.push_back((int)(unsigned int)value);
+            break;
+
+        case Context::ChunkData:
+            m_layers.back().chunks.back().data.push_back((int)(unsigned int)value);
+            break;
+
+        case Context::Chunk: {
+            LayerChunk& chunk = m_layers.back().chunks.back();
+            if (m_key == "x") chunk.x = (int)value;
+            else if (m_key == "y") chunk.y = (int)value;
+            else if (m_key == "width") chunk.width = (int)value;
+            else if (m_key == "height") chunk.height = (int)value;
+            break;
+        }
+
+        case Context::Layer: {
+            TileLayer& layer = m_layers.back().layer;
+            if (m_key == "width") layer.width = (int)value;
+            else if (m_key == "height") layer.height = (int)value;
+            break;
+        }
+
+        case Context::Root:
+            if (m_key == "width") m_map.width = (int)value;
+            else if (m_key == "height") m_map.height = (int)value;
+            else if (m_key == "tilewidth") m_map.tileWidth = (int)value;
+            else if (m_key == "tileheight") m_map.tileHeight = (int)value;
+            break;
+
+        case Context::Capture:
+            AddDomValue(value);
+            break;
+
+        default:
+            break;
+    }
+    return true;
+}
+
+bool TMJStreamParser::Value(json&& value) {
+    if (!m_contexts.empty() && m_contexts.back() == Context::Capture) {
+        AddDomValue(std::move(value));
+    }
+    return true;
+}
+
+//==============================================================================
+// TILESET DOM
+//==============================================================================
+json* TMJStreamParser::AddDomValue(json&& value) {
+    json* parent = m_domStack.back();
+    if (parent->is_array()) {
+        parent->push_back(std::move(value));
+        return &parent->back();
+    }
+    json& slot = (*parent)[m_key];
+    slot = std::move(value);
+    return &slot;
+}
+
+//==============================================================================
+// CONTAINERS
+//==============================================================================
+void TMJStreamParser::BeginContainer(Context context) {
+    m_contexts.push_back(context);
+}
+
+bool TMJStreamParser::key(json::string_t& value) {
+    m_key = std::move(value);
+    return true;
+}
+
+bool TMJStreamParser::start_object(std::size_t) {
+    if (m_contexts.empty()) {
+        BeginContainer(Context::Root);
+        return true;
+    }
+
+    switch (m_contexts.back()) {
+        case Context::Tilesets:
+            m_tileset = json::object();
+            m_domStack.push_back(&m_tileset);
+            BeginContainer(Context::Capture);
+            break;
+
+        case Context::Capture:
+            m_domStack.push_back(AddDomValue(json::object()));
+            BeginContainer(Context::Capture);
+            break;
+
+        case Context::Layers: {
+            LayerState state;
+            state.layer.data.reserve(m_lastLayerSize);
+            m_layers.push_back(std::move(state));
+            BeginContainer(Context::Layer);
+            break;
+        }
+
+        case Context::Chunks:
+            m_layers.back().chunks.emplace_back();
+            BeginContainer(Context::Chunk);
+            break;
+
+        default:
+            BeginContainer(Context::Skip);
+            break;
+    }
+    return true;
+}
+
+bool TMJStreamParser::start_array(std::size_t) {
+    Context parent = m_contexts.empty() ? Context::Skip : m_contexts.back();
+
+    if (parent == Context::Root && m_key == "tilesets") {
+        BeginContainer(Context::Tilesets);
+    }
+    else if (parent == Context::Root && m_key == "layers") {
+        BeginContainer(Context::Layers);
+    }
+    else if (parent == Context::Layer && m_key == "data") {
+        m_layers.back().hasData = true;
+        BeginContainer(Context::LayerData);
+    }
+    else if (parent == Context::Layer && m_key == "chunks") {
+        m_layers.back().hasChunks = true;
+        BeginContainer(Context::Chunks);
+    }
+    else if (parent == Context::Chunk && m_key == "data") {
+        BeginContainer(Context::ChunkData);
+    }
+    else if (parent == Context::Layer && m_key == "layers") {
+        LayerState& group = m_layers.back();
+        group.isGroup = true;
+        group.groupStart = m_map.layers.size();
+        BeginContainer(Context::Layers);
+    }
+    else if (parent == Context::Capture) {
+        m_domStack.push_back(AddDomValue(json::array()));
+        BeginContainer(Context::Capture);
+    }
+    else {
+        BeginContainer(Context::Skip);
+    }
+    return true;
+}
+
+bool TMJStreamParser::end_object() {
+    Context context = m_contexts.back();
+    m_contexts.pop_back();
+
+    if (context == Context::Capture) {
+        m_domStack.pop_back();
+        if (m_domStack.empty()) {
+            MapLoader::ParseTileset(m_tileset, m_map, m_baseDir);
+            m_tileset = nullptr;
+        }
+    }
+    else if (context == Context::Layer) {
+        EndLayer();
+    }
+    else if (context == Context::Root) {
+        return EndRoot();
+    }
+    return true;
+}
+
+bool TMJStreamParser::end_array() {
+    Context context = m_contexts.back();
+    m_contexts.pop_back();
+
+    if (context == Context::Capture) {
+        m_domStack.pop_back();
+    }
+    return true;
+}
+
+//==============================================================================
+// LAYER COMPLETION
+//==============================================================================
+void TMJStreamParser::EndLayer() {
+    LayerState state = std::move(m_layers.back());
+    m_layers.pop_back();
+
+    if (state.isGroup) {
+        // Children were added before the group's name was known
+        if (state.name == "Background") {
+            for (size_t i = state.groupStart; i < m_map.layers.size(); ++i) {
+                m_map.layers[i].group = LayerGroup::Background;
+            }
+        }
+        return;
+    }
+
+    if (state.type != "tilelayer") return;
+    if (m_progress) m_progress->layersDone++;
+
+    // Chunked layers stay empty until the chunk streamer fills their region
+    if (state.hasChunks) {
+        m_chunkedLayers++;
+        for (LayerChunk& chunk : state.chunks) {
+            MapLoader::AddLayerChunk(m_map, state.layer, std::move(chunk));
+        }
+        state.layer.compression = std::move(state.compression);
+        state.layer.width = state.layer.height = 0;
+        m_map.layers.push_back(std::move(state.layer));
+        return;
+    }
+
+    if (state.hasData) m_dataLayers++;
+
+    const size_t tileCount = (size_t)std::max(state.layer.width, 0) * std::max(state.layer.height, 0);
+    if (!state.encodedData.empty()) {
+        if (state.encoding != "base64") {
+            std::cerr << "Warning: Unsupported encoding '" << state.encoding << "' in layer '"
+                      << state.name << "', layer left empty" << std::endl;
+            state.layer.data.assign(tileCount, 0);
+        }
+        else if (!MapLoader::DecodeLayerData(state.encodedData.data(), state.encodedData.size(), state.compression,
+                                             tileCount, state.layer.data)) {
+            std::cerr << "Warning: Layer '" << state.name << "' left empty" << std::endl;
+            state.layer.data.assign(tileCount, 0);
+        }
+    }
+
+    // Plain arrays are taken as they come: width and height may follow data
+    MapLoader::FitLayerData(state.layer.data, tileCount, "Layer '" + state.name + "'");
+
+    m_lastLayerSize = state.layer.data.size();
+    state.layer.group = LayerGroup::Objects;
+    m_map.layers.push_back(std::move(state.layer));
+}
+
+//------------------------------------------------------------------------------
+// "infinite" may have been read before or after the layers: only now can the
+// layers' form be checked against it
+//------------------------------------------------------------------------------
+bool TMJStreamParser::EndRoot() {
+    if (m_map.infinite && m_dataLayers > 0) {
+        std::cerr << "Error: Infinite map has " << m_dataLayers << " tile layer(s) with \"data\" instead of \"chunks\""
+                  << std::endl;
+        return false;
+    }
+    if (!m_map.infinite && m_chunkedLayers > 0) {
+        std::cerr << "Error: Finite map has " << m_chunkedLayers << " tile layer(s) with \"chunks\" instead of \"data\""
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//==============================================================================
+// ERRORS
+//==============================================================================
+bool TMJStreamParser::parse_error(std::size_t position, const std::string& token,
+                                  const nlohmann::detail::exception& error) {
+    std::cerr << "Error: TMJ parse error at byte " << position << " near '" << token << "': "
+              << error.what() << std::endl;
+    return false;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <./json.hpp>
+
+#include "TMJTypes.h"
+
+using json = nlohmann::json;
+
+//==============================================================================
+// TMJ STREAM PARSER
+//==============================================================================
+// SAX handler for json::sax_parse that fills a TMJMap while the file is read.
+// Tile layer GIDs are written straight into TileLayer::data (reserved with the
+// previous layer's size) and only tileset objects are materialised as small
+// DOMs for MapLoader's tileset parsing. Other objects (properties, object
+// layers...) are skipped without being built.
+//
+// Tiled writes keys alphabetically, so a layer's "data" arrives before its
+// "type" and a group's "layers" before its "name": layers are kept or
+// dropped when their object closes, and a group marks the layer range it
+// produced once its name is known. Base64 "data" strings likewise precede
+// their "encoding" and are decoded when the layer closes. Chunks of infinite
+// maps are handed to the layer's chunk table still encoded.
+//
+// The map's "infinite" flag is not relied on while layers are read: it may
+// come after "layers" in files not written by Tiled. Each tile layer is
+// handled by its own content ("chunks" or "data"), and the root object
+// checks on closing that this agrees with the flag.
+class TMJStreamParser {
+public:
+    TMJStreamParser(TMJMap& map, const std::string& baseDir, LoadProgress* progress = nullptr);
+
+    // nlohmann SAX interface
+    bool null();
+    bool boolean(bool value);
+    bool number_integer(json::number_integer_t value);
+    bool number_unsigned(json::number_unsigned_t value);
+    bool number_float(json::number_float_t value, const json::string_t& text);
+    bool string(json::string_t& value);
+    bool binary(json::binary_t& value);
+    bool start_object(std::size_t size);
+    bool key(json::string_t& value);
+    bool end_object();
+    bool start_array(std::size_t size);
+    bool end_array();
+    bool parse_error(std::size_t position, const std::string& token, const nlohmann::detail::exception& error);
+
+private:
+    enum class Context {
+        Root,
+        Tilesets,      // top-level "tilesets" array
+        Capture,       // inside a tileset, built as a DOM
+        Layers,        // a "layers" array (top level or group)
+        Layer,         // a layer object
+        LayerData,     // a layer's "data" array
+        Chunks,        // an infinite layer's "chunks" array
+        Chunk,         // a chunk object
+        ChunkData,     // a chunk's "data" array
+        Skip           // anything else
+    };
+
+    struct LayerState {
+        TileLayer layer;
+        std::string type;
+        std::string name;
+        std::string encodedData;
+        std::string encoding;
+        std::string compression;
+        std::vector<LayerChunk> chunks;
+        size_t groupStart = 0;
+        bool isGroup = false;
+        bool hasData = false;
+        bool hasChunks = false;
+    };
+
+    TMJMap& m_map;
+    std::string m_baseDir;
+    LoadProgress* m_progress;
+
+    std::vector<Context> m_contexts;
+    std::vector<LayerState> m_layers;
+    std::string m_key;
+    size_t m_lastLayerSize = 0;
+    int m_dataLayers = 0;       // tile layers read from "data"
+    int m_chunkedLayers = 0;    // tile layers read from "chunks"
+
+    json m_tileset;
+    std::vector<json*> m_domStack;
+
+    bool Value(json&& value);
+    bool Integer(long long value);
+    json* AddDomValue(json&& value);
+    void BeginContainer(Context context);
+    void EndLayer();
+    bool EndRoot();
+};
@@ -1,8 +1,12 @@
 #pragma once
 #include <raylib.h>
+#include <atomic>
 #include <vector>
 #include <map>
 #include <string>
+#include <unordered_map>
+
+#include "../Core/TextureHandle.h"
 
 //==============================================================================
 // ENUMERATIONS
@@ -15,6 +19,21 @@ enum class ShapeType {
     Unknown
 };
 
+enum class LayerGroup {
+    Background,
+    Objects
+};
+
+enum class LoadStage {
+    Idle,
+    Cache,          // reading the baked cache
+    Parsing,        // map file and tilesets
+    Textures,       // image decoding and GPU upload
+    Tiles,          // tile generation
+    Collisions,     // collision baking
+    Done
+};
+
 enum class PlayerAction {
     Idle,
     Run,
@@ -40,15 +59,85 @@ struct CollisionShape {
     Rectangle rect{0, 0, 0, 0};
 };
 
-// Positioned collision in world space
-struct PositionedCollision {
-    CollisionShape shape;
-    Vector2 position;
+// Range of a tile's collision shapes in TileCollisionTable::shapes
+struct CollisionSpan {
+    int first = 0;
+    int count = 0;
+};
+
+// Collision templates of every tile, indexed by GID. All shapes live in one
+// contiguous pool; tiles without collisions have an empty span.
+struct TileCollisionTable {
+    std::vector<CollisionSpan> byGid;
+    std::vector<CollisionShape> shapes;
+};
+
+// Baked collisions in structure-of-arrays form. Bounds are in world space;
+// polygons and polylines reference their world-space vertices as the range
+// points[firstPoint .. firstPoint + pointCount) of the shared point pool.
+// Polygons are convex. The SAT arrays run parallel to the point pool: entry i
+// holds the unit normal of the edge starting at vertex i and the shape's
+// projection range on it (a single value for polyline segments).
+// Ellipses are inscribed in their bounds and keep their inverse radii.
+struct CollisionStore {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<ShapeType> kind;
+    std::vector<float> invRadiusX;
+    std::vector<float> invRadiusY;
+    std::vector<int> firstPoint;
+    std::vector<int> pointCount;
+    std::vector<Vector2> points;
+    std::vector<Vector2> edgeNormals;
+    std::vector<float> projMin;
+    std::vector<float> projMax;
+};
+
+// Static uniform grid bucketing collisions by their world AABB.
+// Cells are stored CSR-style: the items of cell i are
+// cellItems[cellStart[i] .. cellStart[i + 1]). Each item carries a copy of
+// its shape bounds so a cell can be tested as one contiguous batch.
+struct CollisionGrid {
+    float cellWidth = 0.0f;
+    float cellHeight = 0.0f;
+    Vector2 origin{0, 0};      // world position of cell (0, 0)
+    int columns = 0;
+    int rows = 0;
+    std::vector<int> cellStart;
+    std::vector<int> cellItems;
+    std::vector<float> itemMinX;
+    std::vector<float> itemMinY;
+    std::vector<float> itemMaxX;
+    std::vector<float> itemMaxY;
+};
+
+// Shape counts before and after the bake-time rectangle merge
+struct CollisionStats {
+    int generatedShapes = 0;
+    int bakedShapes = 0;
+};
+
+// Result of sweeping a rectangle through the collision world. time is the
+// fraction of the requested motion that can be travelled before contact.
+struct SweepResult {
+    bool hit = false;
+    float time = 1.0f;
+    Vector2 normal{0, 0};
+};
+
+// Baked collisions of a map with their broadphase
+struct CollisionWorld {
+    CollisionStore store;
+    CollisionGrid grid;
+    CollisionStats stats;
 };
 
 // Tileset data structure
 struct TileSet {
     int firstGid = 0;
+    int tileCount = 0;
     int tileWidth = 0;
     int tileHeight = 0;
     int columns = 1;
@@ -57,17 +146,44 @@ struct TileSet {
     int tileOffsetX = 0;
     int tileOffsetY = 0;
 
-    Texture2D* atlas = nullptr;
-    std::map<int, Texture2D*> tileImages;
+    std::string sourcePath;                       // external tileset file, if any
+    std::string imagePath;                        // atlas tilesets
+    std::map<int, std::string> tileImagePaths;    // image collections, by local id
+
+    TextureHandle atlas;
+    std::map<int, TextureHandle> tileImages;   // image collections: texture holding each tile
+    std::map<int, Rectangle> tileRects;     // image collections: tile area in that texture
 };
 
-// Tile layer data
+// Chunk of an infinite map layer. Base64 chunks keep their encoded text;
+// CSV and plain array chunks are run-length packed once parsed. Either form
+// is decoded when the chunk is streamed in, and the data is released again
+// once it leaves the streamed region.
+struct LayerChunk {
+    int x = 0;                 // top-left cell, in tiles
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    std::string encoded;
+    std::vector<unsigned char> packed;
+    std::vector<int> data;
+};
+
+// Tile layer data. On infinite maps data covers only the streamed region and
+// the whole layer lives in the sparse chunk table, keyed by
+// MapLoader::GetChunkKey of the chunk coordinates.
 struct TileLayer {
     std::vector<int> data;
     int width = 0;
     int height = 0;
+    LayerGroup group = LayerGroup::Objects;
+    std::string compression;                             // of encoded chunks
+    std::unordered_map<long long, LayerChunk> chunks;
 };
 
+// Non-owning selection of a map's layers, in map order
+using LayerView = std::vector<const TileLayer*>;
+
 // Individual tile for rendering
 struct Tile {
     Rectangle source{0, 0, 0, 0};
@@ -79,9 +195,38 @@ struct Tile {
     float drawOffsetY = 0.0f;
 };
 
+// Tiles of grid-aligned layers bucketed by map cell for culling. The tiles
+// of layer l are stored row-major, so cells [c0, c1] of row r form the single
+// run tiles[cellStart[i0] .. cellStart[i1 + 1]) with i = (l * rows + r) * columns + c.
+// margin is the farthest any tile is drawn outside of its own cell and
+// origin the world position of cell (0, 0).
+struct TileGrid {
+    int layerCount = 0;
+    int columns = 0;
+    int rows = 0;
+    float cellWidth = 0.0f;
+    float cellHeight = 0.0f;
+    Vector2 origin{0, 0};
+    Vector2 margin{0, 0};
+    std::vector<int> cellStart;
+    std::vector<Tile> tiles;
+};
+
+// Uniform grid over depth-sorted tiles. Cells list tile indices in ascending
+// order, which is also drawing order.
+struct SpriteIndex {
+    int columns = 0;
+    int rows = 0;
+    float cellWidth = 0.0f;
+    float cellHeight = 0.0f;
+    Vector2 origin{0, 0};      // world position of cell (0, 0)
+    std::vector<int> cellStart;
+    std::vector<int> cellItems;
+};
+
 // Animation data
 struct Animation {
-    Texture2D* texture = nullptr;
+    TextureHandle texture;
     int frameCount = 0;
     int frameWidth = 0;
     int frameHeight = 0;
@@ -90,14 +235,37 @@ struct Animation {
     float timer = 0.0f;
 };
 
-// TMJ Map structure
+// Tileset and local tile id a GID resolves to
+struct GidEntry {
+    int tilesetIndex = -1;
+    int localId = 0;
+};
+
+// TMJ Map structure. Infinite maps stream their layers: width and height are
+// then the size of the streamed region and (originX, originY) its top-left
+// cell, in tiles.
 struct TMJMap {
     int width = 0;
     int height = 0;
     int tileWidth = 0;
     int tileHeight = 0;
+    bool infinite = false;
+    int originX = 0;
+    int originY = 0;
+    int chunkWidth = 0;
+    int chunkHeight = 0;
     std::vector<TileSet> tilesets;
-    std::vector<TileLayer> backgroundLayers;
-    std::vector<TileLayer> otherLayers;
-    std::map<int, std::vector<CollisionShape>> tileCollisions;
+    std::vector<TileLayer> layers;
+    TileCollisionTable tileCollisions;
+    std::vector<GidEntry> gidLookup;
+    std::vector<TextureHandle> textures;   // references held by this map, see MapLoader::UnloadMap
+};
+
+// Progress of a map load, written by the loading thread and polled by the
+// main thread for the loading screen
+struct LoadProgress {
+    std::atomic<LoadStage> stage{LoadStage::Idle};
+    std::atomic<size_t> bytesTotal{0};
+    std::atomic<size_t> bytesParsed{0};
+    std::atomic<int> layersDone{0};
 };
@@ -0,0 +1,308 @@
+#include "TMXLoader.h"
+#include "MapLoader.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+//==============================================================================
+// DOCUMENT
+//==============================================================================
+// The buffer must outlive the document: parsed strings point into it
+bool TMXLoader::LoadDocument(const std::string& path, std::vector<char>& buffer, pugi::xml_document& document) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open " << path << std::endl;
+        return false;
+    }
+
+    buffer.resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+
+    pugi::xml_parse_result result = document.load_buffer_inplace(buffer.data(), buffer.size());
+    if (!result) {
+        std::cerr << "Error: Unable to parse " << path << " at byte " << result.offset
+                  << ": " << result.description() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//==============================================================================
+// PARSE
+//==============================================================================
+bool TMXLoader::Parse(const std::string& tmxPath, TMJMap& map, LoadProgress* progress) {
+    std::vector<char> buffer;
+    pugi::xml_document document;
+    if (!LoadDocument(tmxPath, buffer, document)) return false;
+
+    // The whole document is parsed at once
+    if (progress) {
+        progress->bytesTotal = buffer.size();
+        progress->bytesParsed = buffer.size();
+    }
+
+    pugi::xml_node root = document.child("map");
+    if (!root) {
+        std::cerr << "Error: " << tmxPath << " has no <map> element" << std::endl;
+        return false;
+    }
+
+    map.width = root.attribute("width").as_int();
+    map.height = root.attribute("height").as_int();
+    map.tileWidth = root.attribute("tilewidth").as_int();
+    map.tileHeight = root.attribute("tileheight").as_int();
+    map.infinite = root.attribute("infinite").as_bool();
+
+    const std::string baseDir = FileUtils::GetDirectoryName(tmxPath);
+    for (pugi::xml_node node : root.children("tileset")) {
+        ParseTileset(node, map, baseDir);
+    }
+
+    ParseLayers(root, map, false, progress);
+    return true;
+}
+
+//==============================================================================
+// TILESETS
+//==============================================================================
+void TMXLoader::ParseTileset(const pugi::xml_node& node, TMJMap& map, const std::string& baseDir) {
+    TileSet tileset{};
+    tileset.firstGid = node.attribute("firstgid").as_int();
+
+    // External tileset: the .tsx holds everything but firstgid, and its image
+    // paths are relative to the .tsx itself
+    std::vector<char> externalBuffer;
+    pugi::xml_document externalDocument;
+    pugi::xml_node source = node;
+    std::string imageDir = baseDir;
+
+    if (pugi::xml_attribute external = node.attribute("source")) {
+        std::string tsxPath = FileUtils::ResolvePath(baseDir, external.as_string());
+        // Its GIDs are left unassigned (see MapLoader::BuildGidLookup), not
+        // drawn from the tileset before it
+        if (!LoadDocument(tsxPath, externalBuffer, externalDocument) ||
+            !externalDocument.child("tileset")) {
+            std::cerr << "Warning: External tileset " << tsxPath << " (firstgid " << tileset.firstGid
+                      << ") could not be loaded, its tiles will not be drawn" << std::endl;
+            return;
+        }
+
+        source = externalDocument.child("tileset");
+        imageDir = FileUtils::GetDirectoryName(tsxPath);
+        tileset.sourcePath = tsxPath;
+    }
+
+    tileset.tileCount = source.attribute("tilecount").as_int();
+    tileset.tileWidth = source.attribute("tilewidth").as_int();
+    tileset.tileHeight = source.attribute("tileheight").as_int();
+    tileset.columns = std::max(source.attribute("columns").as_int(), 1);
+
+    if (pugi::xml_node offset = source.child("tileoffset")) {
+        tileset.tileOffsetX = offset.attribute("x").as_int();
+        tileset.tileOffsetY = offset.attribute("y").as_int();
+    }
+
+    if (pugi::xml_node image = source.child("image")) {
+        tileset.isAtlas = true;
+        tileset.imagePath = FileUtils::ResolvePath(imageDir, image.attribute("source").as_string());
+    } else {
+        tileset.isAtlas = false;
+        for (pugi::xml_node tile : source.children("tile")) {
+            pugi::xml_node image = tile.child("image");
+            if (!image || !tile.attribute("id")) continue;
+
+            int localId = tile.attribute("id").as_int();
+            tileset.tileImagePaths[localId] = FileUtils::ResolvePath(imageDir, image.attribute("source").as_string());
+        }
+    }
+
+    ParseTileCollisions(source, tileset, map);
+    map.tilesets.push_back(std::move(tileset));
+}
+
+//------------------------------------------------------------------------------
+void TMXLoader::ParseTileCollisions(const pugi::xml_node& tilesetNode, const TileSet& tileset, TMJMap& map) {
+    for (pugi::xml_node tile : tilesetNode.children("tile")) {
+        pugi::xml_node group = tile.child("objectgroup");
+        if (!group || !tile.attribute("id")) continue;
+
+        int globalId = tileset.firstGid + tile.attribute("id").as_int();
+        const int first = (int)map.tileCollisions.shapes.size();
+
+        for (pugi::xml_node object : group.children("object")) {
+            CollisionShape shape{};
+            float x = object.attribute("x").as_float();
+            float y = object.attribute("y").as_float();
+            float width = object.attribute("width").as_float();
+            float height = object.attribute("height").as_float();
+
+            if (pugi::xml_node polygon = object.child("polygon")) {
+                shape.type = ShapeType::Polygon;
+                shape.points = ParsePoints(polygon.attribute("points").value(), x, y);
+            }
+            else if (pugi::xml_node polyline = object.child("polyline")) {
+                shape.type = ShapeType::Polyline;
+                shape.points = ParsePoints(polyline.attribute("points").value(), x, y);
+            }
+            else if (object.child("ellipse")) {
+                shape.type = ShapeType::Ellipse;
+                shape.rect = {x, y, width, height};
+            }
+            else if (object.child("point") || !object.attribute("width") || !object.attribute("height")) {
+                shape.type = ShapeType::Unknown;
+            }
+            else {
+                shape.type = ShapeType::Rectangle;
+                shape.rect = {x, y, width, height};
+            }
+
+            MapLoader::AddCollisionShape(map, globalId, std::move(shape));
+        }
+
+        MapLoader::SetTileCollisions(map, globalId, first);
+    }
+}
+
+// "x1,y1 x2,y2 ..." relative to the object origin
+std::vector<Vector2> TMXLoader::ParsePoints(const char* text, float originX, float originY) {
+    std::vector<Vector2> points;
+    char* cursor = const_cast<char*>(text);
+
+    while (*cursor) {
+        char* end;
+        float x = std::strtof(cursor, &end);
+        if (end == cursor || *end != ',') break;
+        cursor = end + 1;
+
+        float y = std::strtof(cursor, &end);
+        if (end == cursor) break;
+        cursor = end;
+
+        points.push_back({originX + x, originY + y});
+    }
+    return points;
+}
+
+//==============================================================================
+// LAYERS
+//==============================================================================
+void TMXLoader::ParseLayers(const pugi::xml_node& parent, TMJMap& map, bool isBackground, LoadProgress* progress) {
+    for (pugi::xml_node node : parent.children()) {
+        const char* name = node.name();
+
+        if (std::strcmp(name, "group") == 0) {
+            bool inBackground = isBackground || std::strcmp(node.attribute("name").value(), "Background") == 0;
+            ParseLayers(node, map, inBackground, progress);
+        }
+        else if (std::strcmp(name, "layer") == 0) {
+            TileLayer layer;
+            layer.width = node.attribute("width").as_int();
+            layer.height = node.attribute("height").as_int();
+            layer.group = isBackground ? LayerGroup::Background : LayerGroup::Objects;
+
+            // Infinite layers stay empty until the chunk streamer fills their region
+            if (map.infinite) {
+                if (!ParseChunks(node.child("data"), map, layer)) {
+                    std::cerr << "Warning: Unsupported chunks in layer '" << node.attribute("name").value()
+                              << "'" << std::endl;
+                }
+                layer.width = layer.height = 0;
+            }
+            else {
+                const std::string layerName = node.attribute("name").value();
+                if (!ParseLayerData(node.child("data"), layer)) {
+                    std::cerr << "Warning: Unsupported data in layer '" << layerName
+                              << "', layer left empty" << std::endl;
+                    layer.data.clear();
+                }
+                MapLoader::FitLayerData(layer.data, (size_t)std::max(layer.width, 0) * std::max(layer.height, 0),
+                                        "Layer '" + layerName + "'");
+            }
+            map.layers.push_back(std::move(layer));
+            if (progress) progress->layersDone++;
+        }
+    }
+}
+
+bool TMXLoader::ParseLayerData(const pugi::xml_node& dataNode, TileLayer& layer) {
+    if (!dataNode) return false;
+
+    layer.data.reserve((size_t)layer.width * layer.height);
+    const char* encoding = dataNode.attribute("encoding").value();
+
+    if (std::strcmp(encoding, "csv") == 0) {
+        ParseCSV(dataNode.child_value(), layer.data);
+        return true;
+    }
+
+    if (std::strcmp(encoding, "base64") == 0) {
+        const char* text = dataNode.child_value();
+        return MapLoader::DecodeLayerData(text, std::strlen(text), dataNode.attribute("compression").value(),
+                                          (size_t)layer.width * layer.height, layer.data);
+    }
+
+    // Unencoded: one <tile gid="..."/> per cell
+    if (*encoding == '\0') {
+        for (pugi::xml_node tile : dataNode.children("tile")) {
+            layer.data.push_back((int)tile.attribute("gid").as_uint());
+        }
+        return true;
+    }
+    return false;
+}
+
+// Base64 chunks keep their text (copied out of the document buffer), CSV and
+// unencoded ones are packed by AddLayerChunk; all are decoded when streamed in
+bool TMXLoader::ParseChunks(const pugi::xml_node& dataNode, TMJMap& map, TileLayer& layer) {
+    if (!dataNode) return false;
+
+    const char* encoding = dataNode.attribute("encoding").value();
+    bool csv = std::strcmp(encoding, "csv") == 0;
+    bool base64 = std::strcmp(encoding, "base64") == 0;
+    if (!csv && !base64 && *encoding != '\0') return false;
+
+    layer.compression = dataNode.attribute("compression").value();
+
+    for (pugi::xml_node node : dataNode.children("chunk")) {
+        LayerChunk chunk;
+        chunk.x = node.attribute("x").as_int();
+        chunk.y = node.attribute("y").as_int();
+        chunk.width = node.attribute("width").as_int();
+        chunk.height = node.attribute("height").as_int();
+
+        if (base64) {
+            chunk.encoded = node.child_value();
+        } else if (csv) {
+            chunk.data.reserve((size_t)chunk.width * chunk.height);
+            ParseCSV(node.child_value(), chunk.data);
+        } else {
+            for (pugi::xml_node tile : node.children("tile")) {
+                chunk.data.push_back((int)tile.attribute("gid").as_uint());
+            }
+        }
+        MapLoader::AddLayerChunk(map, layer, std::move(chunk));
+    }
+    return true;
+}
+
+// GIDs carry flip flags in their high bits: parsed as unsigned, kept as the
+// same 32-bit pattern like the TMJ path
+void TMXLoader::ParseCSV(const char* text, std::vector<int>& gids) {
+    const char* cursor = text;
+    while (*cursor) {
+        if (*cursor < '0' || *cursor > '9') {
+            ++cursor;
+            continue;
+        }
+
+        unsigned int value = 0;
+        while (*cursor >= '0' && *cursor <= '9') {
+            value = value * 10 + (unsigned int)(*cursor - '0');
+            ++cursor;
+        }
+        gids.push_back((int)value);
+    }
+}
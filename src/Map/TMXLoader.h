@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "../pugixml.hpp"
+
+#include "TMJTypes.h"
+
+//==============================================================================
+// TMX LOADER
+//==============================================================================
+// Reads Tiled XML maps into the same TMJMap as the JSON path. Files are
+// parsed in place (pugixml parse_buffer_inplace): element names, attributes
+// and CSV/base64 layer text point into the loaded buffer, nothing is copied until
+// the values are converted. External tilesets (.tsx) are followed.
+class TMXLoader {
+public:
+    static bool Parse(const std::string& tmxPath, TMJMap& map, LoadProgress* progress = nullptr);
+
+private:
+    static bool LoadDocument(const std::string& path, std::vector<char>& buffer, pugi::xml_document& document);
+
+    static void ParseTileset(const pugi::xml_node& node, TMJMap& map, const std::string& baseDir);
+    static void ParseTileCollisions(const pugi::xml_node& tilesetNode, const TileSet& tileset, TMJMap& map);
+    static void ParseLayers(const pugi::xml_node& parent, TMJMap& map, bool isBackground, LoadProgress* progress);
+    static bool ParseLayerData(const pugi::xml_node& dataNode, TileLayer& layer);
+    static bool ParseChunks(const pugi::xml_node& dataNode, TMJMap& map, TileLayer& layer);
+    static void ParseCSV(const char* text, std::vector<int>& gids);
+    static std::vector<Vector2> ParsePoints(const char* text, float originX, float originY);
+};
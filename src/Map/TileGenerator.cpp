@@ -1,19 +1,21 @@
 #include "TileGenerator.h"
+#include <algorithm>
+#include <cmath>
 
-std::vector<Tile> TileGenerator::GenerateTiles(const std::vector<TileLayer>& layers, const TMJMap& map) {
+std::vector<Tile> TileGenerator::GenerateTiles(const LayerView& layers, const TMJMap& map) {
     std::vector<Tile> tiles;
     tiles.reserve(layers.size() * 128);
 
-    for (const auto& layer : layers) {
-        for (int y = 0; y < layer.height; ++y) {
-            for (int x = 0; x < layer.width; ++x) {
-                int tileId = layer.data[y * layer.width + x];
+    for (const TileLayer* layer : layers) {
+        for (int y = 0; y < layer->height; ++y) {
+            for (int x = 0; x < layer->width; ++x) {
+                int tileId = layer->data[y * layer->width + x];
                 if (tileId == 0) continue;
 
-                const TileSet* tileset = MapLoader::FindTilesetForGID(map, tileId);
+                int localId = 0;
+                const TileSet* tileset = MapLoader::ResolveGID(map, tileId, localId);
                 if (!tileset) continue;
 
-                int localId = tileId - tileset->firstGid;
                 Tile tile = CreateTile(tileset, localId, x, y, map);
 
                 if (tile.tileset != nullptr) {
@@ -26,14 +28,141 @@ std::vector<Tile> TileGenerator::GenerateTiles(const std::vector<TileLayer>& lay
     return tiles;
 }
 
+//------------------------------------------------------------------------------
+// Same tiles as GenerateTiles, bucketed per layer and cell (counting sort)
+//------------------------------------------------------------------------------
+TileGrid TileGenerator::GenerateTileGrid(const LayerView& layers, const TMJMap& map) {
+    TileGrid grid;
+    grid.layerCount = (int)layers.size();
+    grid.columns = std::max(map.width, 1);
+    grid.rows = std::max(map.height, 1);
+    grid.cellWidth = (float)std::max(map.tileWidth, 1);
+    grid.cellHeight = (float)std::max(map.tileHeight, 1);
+    grid.origin = {map.originX * grid.cellWidth, map.originY * grid.cellHeight};
+
+    const size_t cellsPerLayer = (size_t)grid.columns * grid.rows;
+    const size_t cellCount = cellsPerLayer * grid.layerCount;
+
+    std::vector<Tile> tiles;
+    std::vector<int> cells;
+    tiles.reserve(cellCount);
+    cells.reserve(cellCount);
+
+    for (int l = 0; l < grid.layerCount; ++l) {
+        const TileLayer* layer = layers[l];
+        for (int y = 0; y < layer->height; ++y) {
+            for (int x = 0; x < layer->width; ++x) {
+                int tileId = layer->data[y * layer->width + x];
+                if (tileId == 0) continue;
+
+                int localId = 0;
+                const TileSet* tileset = MapLoader::ResolveGID(map, tileId, localId);
+                if (!tileset) continue;
+
+                Tile tile = CreateTile(tileset, localId, x, y, map);
+                if (tile.tileset == nullptr) continue;
+
+                int col = std::clamp(x, 0, grid.columns - 1);
+                int row = std::clamp(y, 0, grid.rows - 1);
+
+                Rectangle bounds = GetTileBounds(tile);
+                float cellX = grid.origin.x + col * grid.cellWidth;
+                float cellY = grid.origin.y + row * grid.cellHeight;
+                grid.margin.x = std::max({grid.margin.x, cellX - bounds.x,
+                                          bounds.x + bounds.width - (cellX + grid.cellWidth)});
+                grid.margin.y = std::max({grid.margin.y, cellY - bounds.y,
+                                          bounds.y + bounds.height - (cellY + grid.cellHeight)});
+
+                tiles.push_back(tile);
+                cells.push_back((int)(l * cellsPerLayer + (size_t)row * grid.columns + col));
+            }
+        }
+    }
+
+    grid.cellStart.assign(cellCount + 1, 0);
+    for (int cell : cells) {
+        grid.cellStart[cell + 1]++;
+    }
+    for (size_t i = 0; i < cellCount; ++i) {
+        grid.cellStart[i + 1] += grid.cellStart[i];
+    }
+
+    grid.tiles.resize(tiles.size());
+    std::vector<int> cursor(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        grid.tiles[cursor[cells[i]]++] = tiles[i];
+    }
+
+    return grid;
+}
+
+//------------------------------------------------------------------------------
+// Buckets every tile in the cells its drawn rectangle overlaps. Tiles are
+// visited in order, so each cell lists ascending (depth-sorted) indices.
+//------------------------------------------------------------------------------
+SpriteIndex TileGenerator::BuildSpriteIndex(const std::vector<Tile>& tiles, const TMJMap& map) {
+    SpriteIndex index;
+    index.cellWidth = (float)std::max(map.tileWidth, 1) * SPRITE_CELL_TILES;
+    index.cellHeight = (float)std::max(map.tileHeight, 1) * SPRITE_CELL_TILES;
+    index.columns = std::max((map.width + SPRITE_CELL_TILES - 1) / SPRITE_CELL_TILES, 1);
+    index.rows = std::max((map.height + SPRITE_CELL_TILES - 1) / SPRITE_CELL_TILES, 1);
+    index.origin = {(float)map.originX * std::max(map.tileWidth, 1), (float)map.originY * std::max(map.tileHeight, 1)};
+
+    const size_t cellCount = (size_t)index.columns * index.rows;
+    index.cellStart.assign(cellCount + 1, 0);
+
+    auto forEachCell = [&](const Tile& tile, auto&& visit) {
+        Rectangle bounds = GetTileBounds(tile);
+        float x = bounds.x - index.origin.x;
+        float y = bounds.y - index.origin.y;
+        int minCol = std::clamp((int)std::floor(x / index.cellWidth), 0, index.columns - 1);
+        int minRow = std::clamp((int)std::floor(y / index.cellHeight), 0, index.rows - 1);
+        int maxCol = std::clamp((int)std::floor((x + bounds.width) / index.cellWidth), 0, index.columns - 1);
+        int maxRow = std::clamp((int)std::floor((y + bounds.height) / index.cellHeight), 0, index.rows - 1);
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                visit(row * index.columns + col);
+            }
+        }
+    };
+
+    for (const auto& tile : tiles) {
+        forEachCell(tile, [&](int cell) { index.cellStart[cell + 1]++; });
+    }
+    for (size_t i = 0; i < cellCount; ++i) {
+        index.cellStart[i + 1] += index.cellStart[i];
+    }
+
+    index.cellItems.resize(index.cellStart[cellCount]);
+    std::vector<int> cursor(index.cellStart.begin(), index.cellStart.end() - 1);
+    for (int i = 0; i < (int)tiles.size(); ++i) {
+        forEachCell(tiles[i], [&](int cell) { index.cellItems[cursor[cell]++] = i; });
+    }
+
+    return index;
+}
+
+Rectangle TileGenerator::GetTileBounds(const Tile& tile) {
+    return {
+        tile.destination.x, tile.destination.y,
+        std::fabs(tile.source.width), std::fabs(tile.source.height)
+    };
+}
+
 Tile TileGenerator::CreateTile(const TileSet* tileset, int localId, int x, int y, const TMJMap& map) {
     Tile tile{};
     tile.tileset = tileset;
     tile.localId = localId;
-    tile.destination = {(float)x * map.tileWidth, (float)y * map.tileHeight};
+    tile.destination = {(float)(x + map.originX) * map.tileWidth, (float)(y + map.originY) * map.tileHeight};
     tile.isImageCollection = !tileset->isAtlas;
 
     if (tileset->isAtlas) {
+        // Out of the atlas: would sample past the image or another tile
+        if (localId < 0 || (tileset->tileCount > 0 && localId >= tileset->tileCount)) {
+            tile.tileset = nullptr;
+            return tile;
+        }
+
         int columns = (tileset->columns > 0 ? tileset->columns : 1);
         int tx = (localId % columns) * tileset->tileWidth;
         int ty = (localId / columns) * tileset->tileHeight;
@@ -49,20 +178,21 @@ Tile TileGenerator::CreateTile(const TileSet* tileset, int localId, int x, int y
         tile.drawOffsetY = 0.0f;
     } else {
         auto it = tileset->tileImages.find(localId);
-        if (it == tileset->tileImages.end() || it->second == nullptr || it->second->id == 0) {
+        auto rect = tileset->tileRects.find(localId);
+        if (it == tileset->tileImages.end() || !ResourceManager::GetInstance().IsLoaded(it->second) ||
+            rect == tileset->tileRects.end()) {
             tile.tileset = nullptr;
             return tile;
         }
 
-        Texture2D* texture = it->second;
-        tile.source = {0, 0, (float)texture->width, (float)texture->height};
+        tile.source = rect->second;
 
-        float offsetY = (float)map.tileHeight - (float)texture->height;
+        float offsetY = (float)map.tileHeight - rect->second.height;
         tile.destination.y += offsetY;
 
         tile.destination.x += tileset->tileOffsetX;
         tile.destination.y += tileset->tileOffsetY;
-        tile.sortingY = tile.destination.y + (float)texture->height;
+        tile.sortingY = tile.destination.y + rect->second.height;
         tile.drawOffsetY = offsetY + (float)tileset->tileOffsetY;
     }
 
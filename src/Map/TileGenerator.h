@@ -5,8 +5,13 @@
 
 class TileGenerator {
 public:
-    static std::vector<Tile> GenerateTiles(const std::vector<TileLayer>& layers, const TMJMap& map);
+    static std::vector<Tile> GenerateTiles(const LayerView& layers, const TMJMap& map);
+    static TileGrid GenerateTileGrid(const LayerView& layers, const TMJMap& map);
+    static SpriteIndex BuildSpriteIndex(const std::vector<Tile>& tiles, const TMJMap& map);
+    static Rectangle GetTileBounds(const Tile& tile);
 
 private:
+    static constexpr int SPRITE_CELL_TILES = 4;
+
     static Tile CreateTile(const TileSet* tileset, int localId, int x, int y, const TMJMap& map);
 };
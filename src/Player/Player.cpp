@@ -27,24 +27,31 @@ void Player::LoadAnimations() {
         {PlayerDirection::Up, "up.png"}
     };
 
+    // Toutes les planches sont décodées en un seul lot avant l'envoi au GPU
+    std::vector<std::string> keys;
+    std::vector<std::string> paths;
     for (const auto& [action, basePath] : basePaths) {
         for (const auto& [direction, suffix] : directionSuffixes) {
-            std::string key = GetAnimationKey(action, direction);
-            std::string path = basePath + suffix;
+            keys.push_back(GetAnimationKey(action, direction));
+            paths.push_back(basePath + suffix);
+        }
+    }
 
-            Texture2D& texture = resourceMgr.LoadTextureCached(path);
+    std::vector<TextureHandle> textures = resourceMgr.LoadTexturesCached(paths);
 
-            Animation anim{};
-            anim.texture = &texture;
-            anim.frameCount = SPRITE_FRAME_COUNT;
-            anim.frameWidth = (texture.id != 0) ? texture.width / SPRITE_FRAME_COUNT : 0;
-            anim.frameHeight = (texture.id != 0) ? texture.height : 0;
-            anim.currentFrame = 0;
-            anim.frameTime = SPRITE_FRAME_TIME;
-            anim.timer = 0.0f;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const Texture2D& texture = resourceMgr.GetTexture(textures[i]);
 
-            m_animations[key] = anim;
-        }
+        Animation anim{};
+        anim.texture = textures[i];
+        anim.frameCount = SPRITE_FRAME_COUNT;
+        anim.frameWidth = (texture.id != 0) ? texture.width / SPRITE_FRAME_COUNT : 0;
+        anim.frameHeight = (texture.id != 0) ? texture.height : 0;
+        anim.currentFrame = 0;
+        anim.frameTime = SPRITE_FRAME_TIME;
+        anim.timer = 0.0f;
+
+        m_animations[keys[i]] = anim;
     }
 }
 
@@ -72,10 +79,19 @@ Player::Player(float startX, float startY) {
     LoadAnimations();
 }
 
+//------------------------------------------------------------------------------
+// Rend les références des planches de sprites
+Player::~Player() {
+    auto& resourceMgr = ResourceManager::GetInstance();
+    for (const auto& [key, anim] : m_animations) {
+        resourceMgr.ReleaseTexture(anim.texture);
+    }
+}
+
 //==============================================================================
 // UPDATE
 //==============================================================================
-void Player::Update(const std::vector<PositionedCollision>& collisions) {
+void Player::Update(const CollisionWorld& collisions) {
     Vector2 movementVector = {0, 0};
     PlayerAction newAction = PlayerAction::Idle;
 
@@ -111,18 +127,18 @@ void Player::Update(const std::vector<PositionedCollision>& collisions) {
         movementVector = Vector2Normalize(movementVector);
     }
 
-    // Mouvement + collisions
-    Vector2 oldPosition = m_position;
-    m_position.x += movementVector.x * m_speed * GetFrameTime();
-    m_position.y += movementVector.y * m_speed * GetFrameTime();
+    // Mouvement + collisions (balayage continu, glissement le long des murs)
+    Vector2 delta = {
+        movementVector.x * m_speed * GetFrameTime(),
+        movementVector.y * m_speed * GetFrameTime()
+    };
+
+    Vector2 moved = CollisionSystem::MoveAndSlide(collisions, m_hitbox, delta);
+    m_position.x += moved.x;
+    m_position.y += moved.y;
 
     UpdateHitbox();
 
-    if (CollisionSystem::CheckPlayerCollision(m_hitbox, collisions)) {
-        m_position = oldPosition;
-        UpdateHitbox();
-    }
-
     // Animation
     std::string key = GetAnimationKey(m_currentAction, m_currentDirection);
     Animation& anim = m_animations[key];
@@ -138,27 +154,39 @@ void Player::Update(const std::vector<PositionedCollision>& collisions) {
 // DRAW
 //==============================================================================
 void Player::Draw() const {
+    DynamicSprite sprite;
+    if (GetSprite(sprite)) {
+        DrawTexturePro(sprite.texture, sprite.source, sprite.dest, sprite.origin, 0.0f, WHITE);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Sprite de la frame courante, trié par profondeur avec les tuiles
+bool Player::GetSprite(DynamicSprite& sprite) const {
     std::string key = GetAnimationKey(m_currentAction, m_currentDirection);
     const Animation& anim = m_animations.at(key);
 
-    if (!anim.texture || anim.texture->id == 0) return;
+    const Texture2D& texture = ResourceManager::GetInstance().GetTexture(anim.texture);
+    if (texture.id == 0) return false;
 
-    Rectangle sourceRect = {
+    sprite.texture = texture;
+    sprite.source = {
         (float)(anim.currentFrame * anim.frameWidth), 0,
         (float)anim.frameWidth, (float)anim.frameHeight
     };
 
-    Rectangle destRect = {
+    sprite.dest = {
         m_position.x, m_position.y,
         (float)anim.frameWidth * 2, (float)anim.frameHeight * 2
     };
 
-    Vector2 origin = {
+    sprite.origin = {
         (float)anim.frameWidth / 2,
         (float)anim.frameHeight / 2
     };
 
-    DrawTexturePro(*anim.texture, sourceRect, destRect, origin, 0.0f, WHITE);
+    sprite.sortingY = GetSortingY();
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -170,3 +198,8 @@ void Player::DrawDebug() const {
 float Player::GetSortingY() const {
     return m_position.y + 80.0f;
 }
+
+//------------------------------------------------------------------------------
+Vector2 Player::GetCenter() const {
+    return {m_hitbox.x + m_hitbox.width / 2, m_hitbox.y + m_hitbox.height / 2};
+}
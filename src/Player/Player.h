@@ -8,6 +8,7 @@
 #include "../Core/ResourceManager.h"
 #include "../Map/TMJTypes.h"
 #include "../Map/CollisionSystem.h"
+#include "../Render/DepthSorter.h"
 
 //==============================================================================
 // PLAYER CLASS
@@ -35,9 +36,15 @@ private:
 
 public:
     Player(float startX, float startY);
+    ~Player();
 
-    void Update(const std::vector<PositionedCollision>& collisions);
+    Player(const Player&) = delete;
+    Player& operator=(const Player&) = delete;
+
+    void Update(const CollisionWorld& collisions);
     void Draw() const;
+    bool GetSprite(DynamicSprite& sprite) const;
     void DrawDebug() const;
     float GetSortingY() const;
+    Vector2 GetCenter() const;
 };
@@ -0,0 +1,230 @@
+#include "BackgroundCache.h"
+#include "RenderSystem.h"
+#include <rlgl.h>
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+// CONSTRUCTION
+//==============================================================================
+BackgroundCache::BackgroundCache(size_t budgetBytes)
+    : m_budgetBytes(budgetBytes) {}
+
+BackgroundCache::~BackgroundCache() {
+    Clear();
+}
+
+// `grid` may be the grid already set, rewritten in place: the previous
+// geometry is taken from the cached bounds, never from m_grid
+void BackgroundCache::SetGrid(const TileGrid* grid) {
+    m_grid = grid;
+    if (!grid || grid->columns <= 0 || grid->rows <= 0) {
+        Clear();
+        m_maxChunkX = m_minChunkX - 1;
+        m_maxChunkY = m_minChunkY - 1;
+        return;
+    }
+
+    Rectangle bounds = {grid->origin.x, grid->origin.y,
+                        grid->columns * grid->cellWidth, grid->rows * grid->cellHeight};
+    float chunkWidth = (float)(CHUNK_TILES * grid->cellWidth);
+    float chunkHeight = (float)(CHUNK_TILES * grid->cellHeight);
+
+    // Same chunk size: keep the chunks whose tiles are unchanged
+    if (chunkWidth == m_chunkWidth && chunkHeight == m_chunkHeight) {
+        Vector2 margin = {std::max(m_margin.x, grid->margin.x), std::max(m_margin.y, grid->margin.y)};
+        std::vector<long long> stale;
+        for (const auto& [key, chunk] : m_chunks) {
+            if (!IsInside(chunk.chunkX, chunk.chunkY, m_bounds, margin) ||
+                !IsInside(chunk.chunkX, chunk.chunkY, bounds, margin)) {
+                stale.push_back(key);
+            }
+        }
+        for (long long key : stale) {
+            Release(key);
+        }
+    } else {
+        Clear();
+    }
+
+    m_bounds = bounds;
+    m_margin = grid->margin;
+    m_chunkWidth = chunkWidth;
+    m_chunkHeight = chunkHeight;
+    m_minChunkX = (int)std::floor(bounds.x / chunkWidth);
+    m_minChunkY = (int)std::floor(bounds.y / chunkHeight);
+    m_maxChunkX = (int)std::ceil((bounds.x + bounds.width) / chunkWidth) - 1;
+    m_maxChunkY = (int)std::ceil((bounds.y + bounds.height) / chunkHeight) - 1;
+}
+
+void BackgroundCache::Clear() {
+    for (auto& entry : m_chunks) {
+        UnloadRenderTexture(entry.second.target);
+    }
+    m_chunks.clear();
+    m_lru.clear();
+    m_usedBytes = 0;
+}
+
+//==============================================================================
+// CHUNK GEOMETRY
+//==============================================================================
+bool BackgroundCache::GetChunkRange(const Rectangle& view, int& minX, int& minY, int& maxX, int& maxY) const {
+    if (m_maxChunkX < m_minChunkX || m_maxChunkY < m_minChunkY) return false;
+
+    minX = std::max((int)std::floor(view.x / m_chunkWidth), m_minChunkX);
+    minY = std::max((int)std::floor(view.y / m_chunkHeight), m_minChunkY);
+    maxX = std::min((int)std::floor((view.x + view.width) / m_chunkWidth), m_maxChunkX);
+    maxY = std::min((int)std::floor((view.y + view.height) / m_chunkHeight), m_maxChunkY);
+    return minX <= maxX && minY <= maxY;
+}
+
+// Edge chunks are trimmed to the grid so they do not waste texture memory
+Rectangle BackgroundCache::GetChunkRect(int chunkX, int chunkY) const {
+    float left = std::max(chunkX * m_chunkWidth, m_bounds.x);
+    float top = std::max(chunkY * m_chunkHeight, m_bounds.y);
+    float right = std::min((chunkX + 1) * m_chunkWidth, m_bounds.x + m_bounds.width);
+    float bottom = std::min((chunkY + 1) * m_chunkHeight, m_bounds.y + m_bounds.height);
+    return {left, top, right - left, bottom - top};
+}
+
+// Whole chunk, with the tiles overhanging into it, inside `bounds`: its
+// content does not depend on where the grid ends
+bool BackgroundCache::IsInside(int chunkX, int chunkY, const Rectangle& bounds, Vector2 margin) const {
+    float left = chunkX * m_chunkWidth - margin.x;
+    float top = chunkY * m_chunkHeight - margin.y;
+    float right = (chunkX + 1) * m_chunkWidth + margin.x;
+    float bottom = (chunkY + 1) * m_chunkHeight + margin.y;
+    return left >= bounds.x && top >= bounds.y &&
+           right <= bounds.x + bounds.width && bottom <= bounds.y + bounds.height;
+}
+
+//==============================================================================
+// PREPARE (build missing chunks)
+//==============================================================================
+void BackgroundCache::Prepare(const Rectangle& view) {
+    int minX, minY, maxX, maxY;
+    if (!m_grid || !GetChunkRange(view, minX, minY, maxX, maxY)) return;
+
+    // Mark every cached visible chunk as used first so eviction never
+    // releases a chunk that is about to be drawn this frame
+    int pinned = 0;
+    for (int cy = minY; cy <= maxY; ++cy) {
+        for (int cx = minX; cx <= maxX; ++cx) {
+            auto it = m_chunks.find(MapLoader::GetChunkKey(cx, cy));
+            if (it != m_chunks.end()) {
+                Touch(it->second);
+                pinned++;
+            }
+        }
+    }
+
+    int builds = 0;
+    for (int cy = minY; cy <= maxY && builds < MAX_BUILDS_PER_FRAME; ++cy) {
+        for (int cx = minX; cx <= maxX && builds < MAX_BUILDS_PER_FRAME; ++cx) {
+            long long key = MapLoader::GetChunkKey(cx, cy);
+            if (m_chunks.count(key)) continue;
+
+            if (BuildChunk(key, cx, cy, pinned)) {
+                pinned++;
+            }
+            builds++;
+        }
+    }
+}
+
+//==============================================================================
+// BUILD CHUNK
+//==============================================================================
+bool BackgroundCache::BuildChunk(long long key, int chunkX, int chunkY, int pinnedChunks) {
+    Rectangle rect = GetChunkRect(chunkX, chunkY);
+    int width = (int)rect.width;
+    int height = (int)rect.height;
+    size_t bytes = (size_t)GetPixelDataSize(width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    EvictForBuild(bytes, pinnedChunks);
+
+    RenderTexture2D target = LoadRenderTexture(width, height);
+    if (target.id == 0) return false;
+
+    Camera2D camera = {};
+    camera.target = {rect.x, rect.y};
+    camera.zoom = 1.0f;
+
+    // Colour blends as usual but alpha accumulates, so the chunk holds
+    // premultiplied colour and semi-transparent layers composite correctly
+    BeginTextureMode(target);
+    ClearBackground(BLANK);
+    BeginMode2D(camera);
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    RenderSystem::DrawTileGrid(*m_grid, rect);
+    EndBlendMode();
+    EndMode2D();
+    EndTextureMode();
+
+    m_lru.push_front(key);
+    m_chunks[key] = {target, chunkX, chunkY, m_lru.begin()};
+    m_usedBytes += bytes;
+    return true;
+}
+
+//==============================================================================
+// DRAW
+//==============================================================================
+void BackgroundCache::Draw(const Rectangle& view) const {
+    int minX, minY, maxX, maxY;
+    if (!m_grid || !GetChunkRange(view, minX, minY, maxX, maxY)) return;
+
+    // Until every visible chunk is built, draw the tiles directly: mixing
+    // chunks and loose tiles would draw overhanging tiles twice
+    for (int cy = minY; cy <= maxY; ++cy) {
+        for (int cx = minX; cx <= maxX; ++cx) {
+            if (!m_chunks.count(MapLoader::GetChunkKey(cx, cy))) {
+                RenderSystem::DrawTileGrid(*m_grid, view);
+                return;
+            }
+        }
+    }
+
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    for (int cy = minY; cy <= maxY; ++cy) {
+        for (int cx = minX; cx <= maxX; ++cx) {
+            const RenderTexture2D& target = m_chunks.at(MapLoader::GetChunkKey(cx, cy)).target;
+            Rectangle rect = GetChunkRect(cx, cy);
+
+            // Render textures are stored bottom-up: flip with a negative height
+            Rectangle source = {0, 0, (float)target.texture.width, -(float)target.texture.height};
+            DrawTextureRec(target.texture, source, {rect.x, rect.y}, WHITE);
+        }
+    }
+    EndBlendMode();
+}
+
+//==============================================================================
+// LRU
+//==============================================================================
+void BackgroundCache::Touch(Chunk& chunk) {
+    m_lru.splice(m_lru.begin(), m_lru, chunk.lruPosition);
+}
+
+void BackgroundCache::Release(long long key) {
+    auto it = m_chunks.find(key);
+    if (it == m_chunks.end()) return;
+
+    const Texture2D& texture = it->second.target.texture;
+    m_usedBytes -= (size_t)GetPixelDataSize(texture.width, texture.height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    UnloadRenderTexture(it->second.target);
+    m_lru.erase(it->second.lruPosition);
+    m_chunks.erase(it);
+}
+
+// Releases least recently used chunks until `bytes` more fit in the budget.
+// The first `pinnedChunks` entries of the LRU list are visible this frame and
+// are kept even if that means running over budget.
+void BackgroundCache::EvictForBuild(size_t bytes, int pinnedChunks) {
+    while (m_usedBytes + bytes > m_budgetBytes && (int)m_lru.size() > pinnedChunks) {
+        Release(m_lru.back());
+    }
+}
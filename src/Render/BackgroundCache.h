@@ -0,0 +1,76 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <raylib.h>
+
+#include "../Map/TMJTypes.h"
+
+//==============================================================================
+// BACKGROUND CACHE
+//==============================================================================
+// Pre-renders the static background layers into render textures of
+// CHUNK_TILES x CHUNK_TILES cells, so a frame draws one quad per visible chunk
+// instead of every background tile. Chunks are built lazily when they first
+// become visible and the least recently used ones are released once the cache
+// exceeds its memory budget.
+//
+// Chunks are aligned on the world, not on the grid, and keyed by their world
+// chunk coordinates. When SetGrid() switches to another grid of the same map
+// (a streamed region of an infinite map), chunks whose tiles lie inside both
+// grids are kept; only those near the old or new edges are rebuilt.
+//
+// Prepare() renders the missing chunks and must run outside any BeginMode2D
+// block (render-texture mode resets the camera transform); Draw() then draws
+// them in world coordinates.
+class BackgroundCache {
+public:
+    static constexpr int CHUNK_TILES = 16;
+    static constexpr size_t DEFAULT_BUDGET = 32 * 1024 * 1024;
+    static constexpr int MAX_BUILDS_PER_FRAME = 4;
+
+    explicit BackgroundCache(size_t budgetBytes = DEFAULT_BUDGET);
+    ~BackgroundCache();
+
+    BackgroundCache(const BackgroundCache&) = delete;
+    BackgroundCache& operator=(const BackgroundCache&) = delete;
+
+    void SetGrid(const TileGrid* grid);
+    void Prepare(const Rectangle& view);
+    void Draw(const Rectangle& view) const;
+    void Clear();
+
+    int GetChunkCount() const { return (int)m_chunks.size(); }
+    size_t GetMemoryBytes() const { return m_usedBytes; }
+
+private:
+    struct Chunk {
+        RenderTexture2D target;
+        int chunkX;
+        int chunkY;
+        std::list<long long>::iterator lruPosition;
+    };
+
+    const TileGrid* m_grid = nullptr;
+    Rectangle m_bounds{0, 0, 0, 0};     // world area of the grid
+    Vector2 m_margin{0, 0};
+    int m_minChunkX = 0;                // world chunks overlapping the grid
+    int m_minChunkY = 0;
+    int m_maxChunkX = -1;
+    int m_maxChunkY = -1;
+    float m_chunkWidth = 0.0f;
+    float m_chunkHeight = 0.0f;
+    size_t m_budgetBytes;
+    size_t m_usedBytes = 0;
+
+    std::unordered_map<long long, Chunk> m_chunks;
+    std::list<long long> m_lru;    // most recently used first
+
+    bool GetChunkRange(const Rectangle& view, int& minX, int& minY, int& maxX, int& maxY) const;
+    Rectangle GetChunkRect(int chunkX, int chunkY) const;
+    bool IsInside(int chunkX, int chunkY, const Rectangle& bounds, Vector2 margin) const;
+
+    bool BuildChunk(long long key, int chunkX, int chunkY, int pinnedChunks);
+    void Touch(Chunk& chunk);
+    void Release(long long key);
+    void EvictForBuild(size_t bytes, int pinnedChunks);
+};
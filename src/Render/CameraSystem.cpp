@@ -0,0 +1,114 @@
+#include "CameraSystem.h"
+#include <algorithm>
+
+//==============================================================================
+// CONSTRUCTOR
+//==============================================================================
+CameraSystem::CameraSystem(int screenWidth, int screenHeight) {
+    m_screenSize = {(float)screenWidth, (float)screenHeight};
+    m_camera.offset = {m_screenSize.x / 2.0f, m_screenSize.y / 2.0f};
+    m_camera.target = m_camera.offset;
+    m_camera.rotation = 0.0f;
+    m_camera.zoom = 1.0f;
+}
+
+//==============================================================================
+// CONFIGURATION
+//==============================================================================
+void CameraSystem::SetBounds(const Rectangle& worldBounds) {
+    m_bounds = worldBounds;
+    m_hasBounds = (worldBounds.width > 0 && worldBounds.height > 0);
+    ClampToBounds();
+}
+
+void CameraSystem::SetZoom(float zoom) {
+    m_camera.zoom = std::clamp(zoom, MIN_ZOOM, MAX_ZOOM);
+    ClampToBounds();
+}
+
+void CameraSystem::CenterOn(Vector2 target) {
+    m_camera.target = target;
+    ClampToBounds();
+}
+
+//==============================================================================
+// FOLLOW
+//==============================================================================
+// The camera only moves once the target leaves the deadzone, a rectangle of
+// fixed screen size around the view centre.
+void CameraSystem::Follow(Vector2 target) {
+    float halfWidth = DEADZONE_WIDTH / 2.0f / m_camera.zoom;
+    float halfHeight = DEADZONE_HEIGHT / 2.0f / m_camera.zoom;
+
+    if (target.x < m_camera.target.x - halfWidth) m_camera.target.x = target.x + halfWidth;
+    if (target.x > m_camera.target.x + halfWidth) m_camera.target.x = target.x - halfWidth;
+    if (target.y < m_camera.target.y - halfHeight) m_camera.target.y = target.y + halfHeight;
+    if (target.y > m_camera.target.y + halfHeight) m_camera.target.y = target.y - halfHeight;
+
+    ClampToBounds();
+}
+
+void CameraSystem::HandleInput() {
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f) {
+        SetZoom(m_camera.zoom + wheel * ZOOM_STEP);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Keeps the view inside the map; maps smaller than the view are centred.
+//------------------------------------------------------------------------------
+void CameraSystem::ClampToBounds() {
+    if (!m_hasBounds) return;
+
+    float halfViewWidth = m_screenSize.x / 2.0f / m_camera.zoom;
+    float halfViewHeight = m_screenSize.y / 2.0f / m_camera.zoom;
+
+    if (m_bounds.width <= halfViewWidth * 2.0f) {
+        m_camera.target.x = m_bounds.x + m_bounds.width / 2.0f;
+    } else {
+        m_camera.target.x = std::clamp(m_camera.target.x,
+                                       m_bounds.x + halfViewWidth,
+                                       m_bounds.x + m_bounds.width - halfViewWidth);
+    }
+
+    if (m_bounds.height <= halfViewHeight * 2.0f) {
+        m_camera.target.y = m_bounds.y + m_bounds.height / 2.0f;
+    } else {
+        m_camera.target.y = std::clamp(m_camera.target.y,
+                                       m_bounds.y + halfViewHeight,
+                                       m_bounds.y + m_bounds.height - halfViewHeight);
+    }
+}
+
+//==============================================================================
+// RENDERING
+//==============================================================================
+void CameraSystem::Begin() const {
+    BeginMode2D(m_camera);
+}
+
+void CameraSystem::End() const {
+    EndMode2D();
+}
+
+//==============================================================================
+// TRANSFORMS
+//==============================================================================
+Rectangle CameraSystem::GetViewRect() const {
+    float width = m_screenSize.x / m_camera.zoom;
+    float height = m_screenSize.y / m_camera.zoom;
+    return {
+        m_camera.target.x - width / 2.0f,
+        m_camera.target.y - height / 2.0f,
+        width, height
+    };
+}
+
+Vector2 CameraSystem::WorldToScreen(Vector2 position) const {
+    return GetWorldToScreen2D(position, m_camera);
+}
+
+Vector2 CameraSystem::ScreenToWorld(Vector2 position) const {
+    return GetScreenToWorld2D(position, m_camera);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <raylib.h>
+
+//==============================================================================
+// CAMERA SYSTEM
+//==============================================================================
+// Wraps a Camera2D centred on the screen: follows a target through a
+// deadzone, stays inside the map bounds and supports zooming. Everything drawn
+// between Begin() and End() is in world coordinates.
+class CameraSystem {
+private:
+    static constexpr float MIN_ZOOM = 0.5f;
+    static constexpr float MAX_ZOOM = 4.0f;
+    static constexpr float ZOOM_STEP = 0.1f;
+    static constexpr float DEADZONE_WIDTH = 160.0f;   // screen pixels
+    static constexpr float DEADZONE_HEIGHT = 96.0f;   // screen pixels
+
+    Camera2D m_camera;
+    Vector2 m_screenSize;
+    Rectangle m_bounds{0, 0, 0, 0};
+    bool m_hasBounds = false;
+
+    void ClampToBounds();
+
+public:
+    CameraSystem(int screenWidth, int screenHeight);
+
+    void SetBounds(const Rectangle& worldBounds);
+    void SetZoom(float zoom);
+    void CenterOn(Vector2 target);
+    void Follow(Vector2 target);
+    void HandleInput();
+
+    void Begin() const;
+    void End() const;
+
+    const Camera2D& GetCamera() const { return m_camera; }
+    float GetZoom() const { return m_camera.zoom; }
+    Rectangle GetViewRect() const;
+    Vector2 WorldToScreen(Vector2 position) const;
+    Vector2 ScreenToWorld(Vector2 position) const;
+};
@@ -0,0 +1,33 @@
+#include "DepthSorter.h"
+
+//==============================================================================
+// SPRITES
+//==============================================================================
+int DepthSorter::AddSprite() {
+    int handle = (int)m_sprites.size();
+    m_sprites.emplace_back();
+    m_order.push_back(handle);
+    return handle;
+}
+
+void DepthSorter::SetSprite(int handle, const DynamicSprite& sprite) {
+    m_sprites[handle] = sprite;
+}
+
+//==============================================================================
+// SORT
+//==============================================================================
+// Stable insertion sort on the previous frame's order
+void DepthSorter::Sort() {
+    for (int i = 1; i < (int)m_order.size(); ++i) {
+        int handle = m_order[i];
+        float y = m_sprites[handle].sortingY;
+
+        int j = i - 1;
+        while (j >= 0 && m_sprites[m_order[j]].sortingY > y) {
+            m_order[j + 1] = m_order[j];
+            --j;
+        }
+        m_order[j + 1] = handle;
+    }
+}
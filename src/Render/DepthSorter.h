@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include <raylib.h>
+
+// Sprite of a moving entity, drawn among the static tiles by its sortingY
+struct DynamicSprite {
+    Texture2D texture{};
+    Rectangle source{0, 0, 0, 0};
+    Rectangle dest{0, 0, 0, 0};
+    Vector2 origin{0, 0};
+    float sortingY = 0.0f;
+};
+
+//==============================================================================
+// DEPTH SORTER
+//==============================================================================
+// Keeps the dynamic sprites (player, NPCs...) in depth order across frames.
+// Entities only move a little per frame, so the order of the previous frame
+// is nearly sorted and an insertion sort restores it in close to O(N). The
+// static tiles stay sorted once and for all; RenderSystem merges both lists.
+class DepthSorter {
+public:
+    int AddSprite();
+    void SetSprite(int handle, const DynamicSprite& sprite);
+    void Sort();
+
+    // Handles of the sprites in ascending sortingY, valid after Sort()
+    const std::vector<int>& GetOrder() const { return m_order; }
+    const DynamicSprite& GetSprite(int handle) const { return m_sprites[handle]; }
+
+private:
+    std::vector<DynamicSprite> m_sprites;
+    std::vector<int> m_order;
+};
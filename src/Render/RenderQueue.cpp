@@ -0,0 +1,94 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+//==============================================================================
+// SUBMIT
+//==============================================================================
+void RenderQueue::Submit(const Texture2D& texture, const Rectangle& source, const Rectangle& dest, Vector2 origin) {
+    if (texture.id == 0) return;
+
+    Rectangle bounds = {dest.x - origin.x, dest.y - origin.y, dest.width, dest.height};
+    m_commands.push_back({texture, source, dest, origin, bounds});
+}
+
+//==============================================================================
+// BATCHING
+//==============================================================================
+// Greedy pass in submission order: each command joins the most recent batch
+// using the same texture, provided it overlaps none of the batches it would
+// jump over; otherwise it opens a new batch. Commands keep their submission
+// order inside a batch, so any two overlapping commands stay in depth order.
+void RenderQueue::BuildBatches() {
+    m_batches.clear();
+    m_next.assign(m_commands.size(), -1);
+
+    for (int i = 0; i < (int)m_commands.size(); ++i) {
+        const DrawCommand& command = m_commands[i];
+        int target = -1;
+
+        int stop = std::max((int)m_batches.size() - MAX_LOOKBACK, 0);
+        for (int b = (int)m_batches.size() - 1; b >= stop; --b) {
+            if (m_batches[b].textureId == command.texture.id) {
+                target = b;
+                break;
+            }
+            if (Overlaps(m_batches[b].bounds, command.bounds)) break;
+        }
+
+        if (target < 0) {
+            m_batches.push_back({command.texture.id, command.bounds, i, i});
+            continue;
+        }
+
+        Batch& batch = m_batches[target];
+        m_next[batch.last] = i;
+        batch.last = i;
+        batch.bounds = Union(batch.bounds, command.bounds);
+    }
+}
+
+//==============================================================================
+// FLUSH
+//==============================================================================
+void RenderQueue::Flush() {
+    m_lastCommands = (int)m_commands.size();
+    m_lastSwitches = 0;
+    m_lastUnbatchedSwitches = 0;
+
+    unsigned int previous = 0;
+    for (const auto& command : m_commands) {
+        if (command.texture.id != previous) m_lastUnbatchedSwitches++;
+        previous = command.texture.id;
+    }
+
+    BuildBatches();
+
+    previous = 0;
+    for (const auto& batch : m_batches) {
+        if (batch.textureId != previous) m_lastSwitches++;
+        previous = batch.textureId;
+
+        for (int i = batch.first; i >= 0; i = m_next[i]) {
+            const DrawCommand& command = m_commands[i];
+            DrawTexturePro(command.texture, command.source, command.dest, command.origin, 0.0f, WHITE);
+        }
+    }
+
+    m_commands.clear();
+}
+
+//==============================================================================
+// HELPERS
+//==============================================================================
+bool RenderQueue::Overlaps(const Rectangle& a, const Rectangle& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width &&
+           a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+Rectangle RenderQueue::Union(const Rectangle& a, const Rectangle& b) {
+    float minX = std::min(a.x, b.x);
+    float minY = std::min(a.y, b.y);
+    float maxX = std::max(a.x + a.width, b.x + b.width);
+    float maxY = std::max(a.y + a.height, b.y + b.height);
+    return {minX, minY, maxX - minX, maxY - minY};
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <raylib.h>
+
+//==============================================================================
+// RENDER QUEUE
+//==============================================================================
+// Collects a frame's sprite draws in depth (y-sort) order and flushes them
+// grouped by texture. A command may only be moved ahead of commands whose
+// screen area it does not overlap, so the final image is identical to drawing
+// in submission order while raylib's batch is broken far less often.
+class RenderQueue {
+public:
+    static constexpr int MAX_LOOKBACK = 64;    // batches searched per command
+
+    void Submit(const Texture2D& texture, const Rectangle& source, const Rectangle& dest,
+                Vector2 origin = {0, 0});
+    void Flush();
+
+    int GetCommandCount() const { return m_lastCommands; }
+    int GetTextureSwitches() const { return m_lastSwitches; }
+    int GetUnbatchedSwitches() const { return m_lastUnbatchedSwitches; }
+
+private:
+    struct DrawCommand {
+        Texture2D texture;
+        Rectangle source;
+        Rectangle dest;
+        Vector2 origin;
+        Rectangle bounds;
+    };
+
+    struct Batch {
+        unsigned int textureId;
+        Rectangle bounds;    // union of the commands' bounds
+        int first;
+        int last;
+    };
+
+    std::vector<DrawCommand> m_commands;
+    std::vector<Batch> m_batches;
+    std::vector<int> m_next;    // next command in the same batch, -1 at the end
+
+    int m_lastCommands = 0;
+    int m_lastSwitches = 0;
+    int m_lastUnbatchedSwitches = 0;
+
+    void BuildBatches();
+    static bool Overlaps(const Rectangle& a, const Rectangle& b);
+    static Rectangle Union(const Rectangle& a, const Rectangle& b);
+};
@@ -1,6 +1,10 @@
 #include "RenderSystem.h"
 #include <raymath.h>
 #include <algorithm>
+#include <cmath>
+
+int RenderSystem::s_tilesDrawn = 0;
+std::vector<int> RenderSystem::s_visibleItems;
 
 //==============================================================================
 // DRAW TILE
@@ -8,16 +12,18 @@
 void RenderSystem::DrawTile(const Tile& tile) {
     if (!tile.tileset) return;
 
+    TextureHandle handle = tile.tileset->atlas;
     if (tile.isImageCollection) {
         auto it = tile.tileset->tileImages.find(tile.localId);
-        if (it == tile.tileset->tileImages.end() || !it->second || it->second->id == 0) {
-            return;
-        }
-        DrawTextureRec(*it->second, tile.source, tile.destination, WHITE);
-    } else {
-        if (!tile.tileset->atlas || tile.tileset->atlas->id == 0) return;
-        DrawTextureRec(*tile.tileset->atlas, tile.source, tile.destination, WHITE);
+        if (it == tile.tileset->tileImages.end()) return;
+        handle = it->second;
     }
+
+    const Texture2D& texture = ResourceManager::GetInstance().GetTexture(handle);
+    if (texture.id == 0) return;
+
+    DrawTextureRec(texture, tile.source, tile.destination, WHITE);
+    s_tilesDrawn++;
 }
 
 //==============================================================================
@@ -30,61 +36,162 @@ void RenderSystem::DrawTiles(const std::vector<Tile>& tiles) {
 }
 
 //==============================================================================
-// DRAW TILES + PLAYER
+// DRAW CULLED TILE GRID
 //==============================================================================
-void RenderSystem::DrawTilesWithPlayer(std::vector<Tile>& tiles, const Player& player) {
-    bool playerDrawn = false;
-    float playerY = player.GetSortingY();
+void RenderSystem::DrawTileGrid(const TileGrid& grid, const Rectangle& view) {
+    if (grid.tiles.empty()) return;
 
-    for (const auto& tile : tiles) {
-        if (!playerDrawn && playerY < tile.sortingY) {
-            player.Draw();
-            playerDrawn = true;
+    float x = view.x - grid.origin.x;
+    float y = view.y - grid.origin.y;
+    int minCol = std::max((int)std::floor((x - grid.margin.x) / grid.cellWidth), 0);
+    int minRow = std::max((int)std::floor((y - grid.margin.y) / grid.cellHeight), 0);
+    int maxCol = std::min((int)std::floor((x + view.width + grid.margin.x) / grid.cellWidth), grid.columns - 1);
+    int maxRow = std::min((int)std::floor((y + view.height + grid.margin.y) / grid.cellHeight), grid.rows - 1);
+    if (minCol > maxCol || minRow > maxRow) return;
+
+    for (int layer = 0; layer < grid.layerCount; ++layer) {
+        for (int row = minRow; row <= maxRow; ++row) {
+            size_t rowStart = ((size_t)layer * grid.rows + row) * grid.columns;
+            int first = grid.cellStart[rowStart + minCol];
+            int last = grid.cellStart[rowStart + maxCol + 1];
+            for (int i = first; i < last; ++i) {
+                DrawTile(grid.tiles[i]);
+            }
         }
-        DrawTile(tile);
     }
+}
+
+//==============================================================================
+// SUBMIT TILE
+//==============================================================================
+void RenderSystem::SubmitTile(RenderQueue& queue, const Tile& tile) {
+    if (!tile.tileset) return;
 
-    if (!playerDrawn) {
-        player.Draw();
+    TextureHandle handle = tile.tileset->atlas;
+    if (tile.isImageCollection) {
+        auto it = tile.tileset->tileImages.find(tile.localId);
+        if (it == tile.tileset->tileImages.end()) return;
+        handle = it->second;
+    }
+
+    const Texture2D& texture = ResourceManager::GetInstance().GetTexture(handle);
+    if (texture.id == 0) return;
+
+    queue.Submit(texture, tile.source, TileGenerator::GetTileBounds(tile));
+    s_tilesDrawn++;
+}
+
+//==============================================================================
+// SUBMIT TILES + DYNAMIC SPRITES
+//==============================================================================
+// The visible tiles come out of the sprite index already in depth order and
+// the dynamic sprites are kept sorted by the DepthSorter, so the two lists are
+// merged: each sprite finds its slot among the visible tiles by binary search,
+// giving O(visible + N log visible) instead of re-sorting everything.
+void RenderSystem::SubmitTilesWithSprites(RenderQueue& queue, const std::vector<Tile>& tiles, const SpriteIndex& index,
+                                          const Rectangle& view, const DepthSorter& sprites) {
+    // Gather the tiles of the visible cells; ascending indices keep depth order
+    std::vector<int>& visible = s_visibleItems;
+    visible.clear();
+
+    if (index.columns > 0 && index.rows > 0) {
+        float x = view.x - index.origin.x;
+        float y = view.y - index.origin.y;
+        int minCol = std::clamp((int)std::floor(x / index.cellWidth), 0, index.columns - 1);
+        int minRow = std::clamp((int)std::floor(y / index.cellHeight), 0, index.rows - 1);
+        int maxCol = std::clamp((int)std::floor((x + view.width) / index.cellWidth), 0, index.columns - 1);
+        int maxRow = std::clamp((int)std::floor((y + view.height) / index.cellHeight), 0, index.rows - 1);
+
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                int cell = row * index.columns + col;
+                visible.insert(visible.end(),
+                    index.cellItems.begin() + index.cellStart[cell],
+                    index.cellItems.begin() + index.cellStart[cell + 1]);
+            }
+        }
+
+        std::sort(visible.begin(), visible.end());
+        visible.erase(std::unique(visible.begin(), visible.end()), visible.end());
+    }
+
+    size_t next = 0;
+    for (int handle : sprites.GetOrder()) {
+        const DynamicSprite& sprite = sprites.GetSprite(handle);
+
+        // A sprite is drawn after every tile whose sortingY is not greater
+        auto slot = std::upper_bound(visible.begin() + next, visible.end(), sprite.sortingY,
+            [&](float y, int i) { return y < tiles[i].sortingY; });
+        size_t end = slot - visible.begin();
+
+        for (; next < end; ++next) {
+            const Tile& tile = tiles[visible[next]];
+            if (CheckCollisionRecs(TileGenerator::GetTileBounds(tile), view)) {
+                SubmitTile(queue, tile);
+            }
+        }
+
+        Rectangle bounds = {sprite.dest.x - sprite.origin.x, sprite.dest.y - sprite.origin.y,
+                            sprite.dest.width, sprite.dest.height};
+        if (CheckCollisionRecs(bounds, view)) {
+            queue.Submit(sprite.texture, sprite.source, sprite.dest, sprite.origin);
+        }
+    }
+
+    for (; next < visible.size(); ++next) {
+        const Tile& tile = tiles[visible[next]];
+        if (CheckCollisionRecs(TileGenerator::GetTileBounds(tile), view)) {
+            SubmitTile(queue, tile);
+        }
     }
 }
 
 //==============================================================================
 // DEBUG COLLISIONS
 //==============================================================================
-void RenderSystem::DrawCollisionDebug(const std::vector<PositionedCollision>& collisions, Vector2 offset) {
-    for (const auto& collision : collisions) {
-        DrawCollisionShape(collision, offset);
+void RenderSystem::DrawCollisionDebug(const CollisionWorld& collisions, const Rectangle& view, Vector2 offset) {
+    std::vector<int>& visible = s_visibleItems;
+    CollisionSystem::QueryCollisions(collisions, view, visible);
+
+    for (int index : visible) {
+        DrawCollisionShape(collisions.store, index, offset);
     }
 }
 
+//==============================================================================
+// STATS
+//==============================================================================
+void RenderSystem::ResetStats() {
+    s_tilesDrawn = 0;
+}
+
+int RenderSystem::GetTilesDrawn() {
+    return s_tilesDrawn;
+}
+
 //==============================================================================
 // DRAW INDIVIDUAL COLLISION SHAPE
 //==============================================================================
-void RenderSystem::DrawCollisionShape(const PositionedCollision& collision, Vector2 offset) {
-    const auto& shape = collision.shape;
-    Vector2 shapeOffset = {
-        collision.position.x + offset.x,
-        collision.position.y + offset.y
-    };
+void RenderSystem::DrawCollisionShape(const CollisionStore& collisions, int index, Vector2 offset) {
+    float minX = collisions.minX[index] + offset.x;
+    float minY = collisions.minY[index] + offset.y;
+    float width = collisions.maxX[index] - collisions.minX[index];
+    float height = collisions.maxY[index] - collisions.minY[index];
 
-    switch (shape.type) {
+    const Vector2* points = collisions.points.data() + collisions.firstPoint[index];
+    int pointCount = collisions.pointCount[index];
+
+    switch (collisions.kind[index]) {
         case ShapeType::Rectangle:
-            DrawRectangleLines(
-                (int)(shape.rect.x + shapeOffset.x),
-                (int)(shape.rect.y + shapeOffset.y),
-                (int)shape.rect.width,
-                (int)shape.rect.height,
-                RED
-            );
+            DrawRectangleLines((int)minX, (int)minY, (int)width, (int)height, RED);
             break;
 
         case ShapeType::Ellipse: {
-            float rx = shape.rect.width / 2.0f;
-            float ry = shape.rect.height / 2.0f;
+            float rx = width / 2.0f;
+            float ry = height / 2.0f;
             DrawEllipseLines(
-                (int)(shape.rect.x + shapeOffset.x + rx),
-                (int)(shape.rect.y + shapeOffset.y + ry),
+                (int)(minX + rx),
+                (int)(minY + ry),
                 (int)rx, (int)ry,
                 ORANGE
             );
@@ -92,20 +199,20 @@ void RenderSystem::DrawCollisionShape(const PositionedCollision& collision, Vect
         }
 
         case ShapeType::Polygon:
-            if (shape.points.size() > 1) {
-                for (size_t i = 0; i < shape.points.size(); ++i) {
-                    Vector2 a = Vector2Add(shape.points[i], shapeOffset);
-                    Vector2 b = Vector2Add(shape.points[(i + 1) % shape.points.size()], shapeOffset);
+            if (pointCount > 1) {
+                for (int i = 0; i < pointCount; ++i) {
+                    Vector2 a = Vector2Add(points[i], offset);
+                    Vector2 b = Vector2Add(points[(i + 1) % pointCount], offset);
                     DrawLineV(a, b, BLUE);
                 }
             }
             break;
 
         case ShapeType::Polyline:
-            if (shape.points.size() > 1) {
-                for (size_t i = 0; i < shape.points.size() - 1; ++i) {
-                    Vector2 a = Vector2Add(shape.points[i], shapeOffset);
-                    Vector2 b = Vector2Add(shape.points[i + 1], shapeOffset);
+            if (pointCount > 1) {
+                for (int i = 0; i < pointCount - 1; ++i) {
+                    Vector2 a = Vector2Add(points[i], offset);
+                    Vector2 b = Vector2Add(points[i + 1], offset);
                     DrawLineV(a, b, PURPLE);
                 }
             }
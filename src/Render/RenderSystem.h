@@ -3,7 +3,11 @@
 #include <raylib.h>
 
 #include "../Map/TMJTypes.h"
-#include "../Player/Player.h"
+#include "../Map/TileGenerator.h"
+#include "../Map/CollisionSystem.h"
+#include "../Core/ResourceManager.h"
+#include "RenderQueue.h"
+#include "DepthSorter.h"
 
 //==============================================================================
 // RENDER SYSTEM
@@ -12,9 +16,18 @@ class RenderSystem {
 public:
     static void DrawTile(const Tile& tile);
     static void DrawTiles(const std::vector<Tile>& tiles);
-    static void DrawTilesWithPlayer(std::vector<Tile>& tiles, const Player& player);
-    static void DrawCollisionDebug(const std::vector<PositionedCollision>& collisions, Vector2 offset = {0, 0});
+    static void DrawTileGrid(const TileGrid& grid, const Rectangle& view);
+    static void SubmitTile(RenderQueue& queue, const Tile& tile);
+    static void SubmitTilesWithSprites(RenderQueue& queue, const std::vector<Tile>& tiles, const SpriteIndex& index,
+                                       const Rectangle& view, const DepthSorter& sprites);
+    static void DrawCollisionDebug(const CollisionWorld& collisions, const Rectangle& view, Vector2 offset = {0, 0});
+
+    static void ResetStats();
+    static int GetTilesDrawn();
 
 private:
-    static void DrawCollisionShape(const PositionedCollision& collision, Vector2 offset);
+    static int s_tilesDrawn;
+    static std::vector<int> s_visibleItems;
+
+    static void DrawCollisionShape(const CollisionStore& collisions, int index, Vector2 offset);
 };
@@ -1,12 +1,13 @@
 // main.cpp - Point d’entrée du moteur Raylib + Tiled TMJ Game Engine
 #include "Game/Game.h"
 
-int main() {
+int main(int argc, char* argv[]) {
     // Créer et exécuter le jeu
     Game game;
 
-    // IMPORTANT : Indique le chemin vers ton fichier TMJ ici
-    const std::string mapPath = "./assets/maps/map.tmj";
+    // IMPORTANT : Indique le chemin vers ton fichier TMJ (ou TMX) ici,
+    // ou passe-le en argument de la ligne de commande
+    const std::string mapPath = (argc > 1) ? argv[1] : "./assets/maps/map.tmj";
 
     game.Run(mapPath);
 